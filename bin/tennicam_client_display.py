@@ -92,26 +92,26 @@ def run() -> None:
     # getting a frontend for ball control
     ball = handle.frontends["ball"]
 
-    # getting a frontend to the visually tracked ball
-    frontend = tennicam_client.FrontEnd(TENNICAM_CLIENT_DEFAULT_SEGMENT_ID)
+    # waiting for the balls produced by tennicam_client
+    waiter = tennicam_client.BallWaiter(TENNICAM_CLIENT_DEFAULT_SEGMENT_ID)
 
-    # running at 100Hz
-    frequency = 100.0
-    frequency_manager = o80.FrequencyManager(frequency)
-    duration_ms = o80.Duration_us.microseconds(int((1.0 / frequency) * 1e6))
+    # the mujoco ball is updated as soon as a new ball is observed
+    # (nothing is done while the ball is out of view)
+    timeout_us = 100000
+    duration_ms = o80.Duration_us.microseconds(10000)
 
     signal_handler.init()  # for detecting ctrl+c
     try:
         while not signal_handler.has_received_sigint():
             # getting information from tennicam
-            ball_zmq = frontend.latest()
-            position = ball_zmq.get_position()
-            velocity = ball_zmq.get_velocity()
+            ball_zmq = waiter.wait(timeout_us)
+            if ball_zmq is None:
+                continue
+            position = ball_zmq["position"].tolist()
+            velocity = ball_zmq["velocity"].tolist()
             # sending related command to mujoco ball
             ball.add_command(position, velocity, duration_ms, o80.Mode.OVERWRITE)
             ball.pulse()
-            # imposing frequency
-            frequency_manager.wait()
     except (KeyboardInterrupt, SystemExit):
         return
 
@@ -9,11 +9,16 @@ with:
 - time_stamp: int (nanoseconds)
 - position: 3d tuple
 - velocity: 3d tuple
+For all frames published by tennicam to be logged (and not only one
+frame per iteration of tennicam_client), set ingestion_policy = "all"
+in the [driver] section of the tennicam_client configuration file.
 """
 
 
 import sys
+import time
 import pathlib
+import numpy
 import signal_handler
 import tennicam_client
 from lightargs import BrightArgs
@@ -45,19 +50,31 @@ def _run(segment_id: str, filepath: pathlib.Path):
     string in filepath.
     """
 
-    frontend = tennicam_client.FrontEnd(segment_id)
-    iteration = frontend.latest().get_iteration()
-
-    getters = ("get_ball_id", "get_time_stamp", "get_position", "get_velocity")
+    frontend = tennicam_client.get_frontend(segment_id)
+    iteration = frontend.latest().get_iteration() + 1
+    buffer = numpy.empty(10000, dtype=tennicam_client.ball_dtype)
 
     with filepath.open(mode="w") as f:
         try:
             while not signal_handler.has_received_sigint():
-                iteration += 1
-                obs = frontend.read(iteration)
-                values = tuple((getattr(obs, getter)() for getter in getters))
-                f.write(repr(values))
-                f.write("\n")
+                # all the balls written since the previous read,
+                # in a single call
+                balls = tennicam_client.read_balls(
+                    frontend, iteration, iteration + len(buffer), buffer
+                )
+                if len(balls) == 0:
+                    time.sleep(0.005)
+                    continue
+                iteration += len(balls)
+                for ball in balls:
+                    values = (
+                        int(ball["ball_id"]),
+                        int(ball["time_stamp"]),
+                        ball["position"].tolist(),
+                        ball["velocity"].tolist(),
+                    )
+                    f.write(repr(values))
+                    f.write("\n")
         except (KeyboardInterrupt, SystemExit):
             pass
         except Exception as e:
@@ -15,7 +15,7 @@ TENNICAM_CLIENT_DEFAULT_SEGMENT_ID = "tennicam_client"
 
 def run():
     global TENNICAM_CLIENT_DEFAULT_SEGMENT_ID
-    frontend = tennicam_client.FrontEnd(TENNICAM_CLIENT_DEFAULT_SEGMENT_ID)
+    frontend = tennicam_client.get_frontend(TENNICAM_CLIENT_DEFAULT_SEGMENT_ID)
     iteration = frontend.latest().get_iteration()
     signal_handler.init()  # for detecting ctrl+c
     try:
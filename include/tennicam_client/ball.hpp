@@ -1,14 +1,35 @@
 #pragma once
 
 #include <array>
+#include <cereal/archives/binary.hpp>
 #include <iomanip>
 #include <sstream>
+#include <type_traits>
 #include "o80/sensor_state.hpp"
 #include "shared_memory/serializer.hpp"
 #include "shared_memory/shared_memory.hpp"
+#include "tennicam_client/ball_record.hpp"
 
 namespace tennicam_client
 {
+/**
+ * @brief Flags of Ball::get_events (see TrajectorySegmenter)
+ */
+enum BallEvent
+{
+    // first ball of a trajectory segment
+    SEGMENT_START = 1,
+    // the segment started with a bounce (the vertical velocity
+    // changed from downward to upward)
+    BOUNCE = 2,
+    // the segment started with a hit (the velocity along the hit axis
+    // changed sign)
+    HIT = 4,
+    // the observed position is inconsistent with the previous ones
+    // (see OutlierGate), it was not used for the velocity estimation
+    OUTLIER = 8
+};
+
 /**
  * @brief A ball characterized by its 3d position and velocity,
  * a (unique) ball_id and a time stamp.
@@ -25,8 +46,8 @@ class Ball : public o80::SensorState
 public:
     /**
      * @brief constuct a ball with ball_id to value -1,
-     * i.e. "invalid ball". The other attributes are not
-     * defined.
+     * i.e. "invalid ball", and time stamps to -1. The position
+     * and velocity are not defined.
      */
     Ball();
     /**
@@ -36,6 +57,10 @@ public:
          const std::array<double, 3>& position,
          const std::array<double, 3>& velocity,
          long int time_stamp_ns);
+    /**
+     * @brief ball corresponding to the record (see to_record)
+     */
+    explicit Ball(const BallRecord& record);
     void set_position(double x, double y, double z);
     void set_velocity(double dx, double dy, double dz);
     void set(const std::array<double, 3>& position,
@@ -54,13 +79,69 @@ public:
      * returns the time stamp, in nanoseconds
      */
     long int get_time_stamp() const;
+    /**
+     * sets the time stamp (nanoseconds), the compensated time stamp
+     * being set to the same value
+     */
+    void set_time_stamp(long int time_stamp_ns);
+    /**
+     * time stamp (nanoseconds) the position and velocity correspond to.
+     * Same as get_time_stamp, except if the driver extrapolated the
+     * ball to the time it was written in the shared memory (see
+     * DriverConfig::latency_compensation).
+     */
+    long int get_compensated_time_stamp() const;
+    void set_compensated_time_stamp(long int time_stamp_ns);
+    /**
+     * number of frames received from tennicam just before this ball
+     * and discarded by the driver (IngestionPolicy::LATEST)
+     */
+    long int get_nb_skipped_frames() const;
+    void set_nb_skipped_frames(long int nb_skipped_frames);
+    /**
+     * id of the trajectory segment the ball belongs to (-1 if
+     * the driver does not segment trajectories), and flags of the
+     * events detected at this ball (see BallEvent)
+     */
+    long int get_segment_id() const;
+    int get_events() const;
+    void set_segment(long int segment_id, int events);
     std::string to_string() const;
+    /**
+     * @brief flat, trivially copyable, representation of the ball
+     */
+    BallRecord to_record() const;
 
 public:
     template <class Archive>
     void serialize(Archive& archive)
     {
-        archive(position_, velocity_, ball_id_, time_stamp_ns_);
+        // binary archives (used by shared_memory, i.e. for the o80
+        // history): the ball is written / read as a single block
+        if constexpr (std::is_same<Archive,
+                                   cereal::BinaryOutputArchive>::value)
+        {
+            BallRecord record = to_record();
+            archive(cereal::binary_data(&record, sizeof(BallRecord)));
+        }
+        else if constexpr (std::is_same<Archive,
+                                        cereal::BinaryInputArchive>::value)
+        {
+            BallRecord record;
+            archive(cereal::binary_data(&record, sizeof(BallRecord)));
+            *this = Ball(record);
+        }
+        else
+        {
+            archive(position_,
+                    velocity_,
+                    ball_id_,
+                    time_stamp_ns_,
+                    compensated_time_stamp_ns_,
+                    nb_skipped_frames_,
+                    segment_id_,
+                    events_);
+        }
     }
 
 private:
@@ -70,6 +151,10 @@ private:
     std::array<double, 3> position_;
     std::array<double, 3> velocity_;
     long int time_stamp_ns_;
+    long int compensated_time_stamp_ns_;
+    long int nb_skipped_frames_;
+    long int segment_id_;
+    int events_;
 };
 
 }  // namespace tennicam_client
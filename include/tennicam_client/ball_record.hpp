@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace tennicam_client
+{
+/**
+ * @brief Flat, trivially copyable representation of a Ball (see
+ * Ball::to_record), which can be written to / read from memory
+ * with a single memcpy.
+ * The layout is fixed (no implicit padding, see static asserts below).
+ */
+struct BallRecord
+{
+    std::int64_t ball_id;
+    // nanoseconds
+    std::int64_t time_stamp;
+    std::int64_t compensated_time_stamp;
+    std::int64_t nb_skipped_frames;
+    std::int64_t segment_id;
+    double position[3];
+    double velocity[3];
+    std::int32_t events;
+    // explicit padding, so that the size is a multiple of 8
+    std::int32_t reserved;
+};
+
+static_assert(std::is_trivially_copyable<BallRecord>::value &&
+                  std::is_standard_layout<BallRecord>::value,
+              "BallRecord should be trivially copyable");
+static_assert(sizeof(BallRecord) == 96, "unexpected size of BallRecord");
+
+}  // namespace tennicam_client
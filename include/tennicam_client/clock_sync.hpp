@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "tennicam_client/seqlock.hpp"
+#include "tennicam_client/shared_record.hpp"
+
+// maximal number of windows used by ClockSync
+#define TENNICAM_CLIENT_CLOCK_SYNC_MAX_WINDOWS 128
+
+namespace tennicam_client
+{
+/**
+ * @brief Estimated relation between the clock of tennicam (time stamps
+ * of the frames) and the local clock (see ClockSync):
+ * local = remote + offset_ns + drift * 1e-6 * (remote - reference_time_stamp)
+ */
+class ClockOffset
+{
+public:
+    ClockOffset();
+    /**
+     * @brief local time (nanoseconds) corresponding to the remote time
+     * (nanoseconds). Returns the remote time if not synchronized.
+     */
+    long int to_local(long int remote) const;
+    std::string to_string() const;
+
+public:
+    // false until enough frames have been received
+    bool synchronized;
+    // nanoseconds, at reference_time_stamp
+    long int offset_ns;
+    // parts per million
+    double drift;
+    // remote time (nanoseconds)
+    long int reference_time_stamp;
+    // number of windows the estimation is based on
+    long int nb_windows;
+    // number of times the estimation restarted (e.g. the clock
+    // of tennicam jumped)
+    long int nb_resets;
+};
+
+/**
+ * @brief Estimates the offset and the drift between the clock of
+ * tennicam and the local clock from the time stamps of the frames and
+ * the local times at which they have been received.
+ * The difference between the two (the "delay") is the clock offset plus
+ * the transmission latency, which is always positive but varies (network,
+ * queueing). The minimum delay over each window of window_ns (remote
+ * time) is therefore used as a measurement of the offset (plus the
+ * minimal latency), and offset and drift are fitted (least squares) over
+ * the minima of the latest nb_windows windows. The latency_ns (e.g. the
+ * known minimal latency of the network) is subtracted from the offset.
+ * If the minimal delay of a window differs from the estimation by more
+ * than reset_threshold_ns (clock of tennicam or local clock set), the
+ * estimation restarts from this window.
+ * Constant cost per frame (except at the end of windows) and no memory
+ * allocation.
+ */
+class ClockSync
+{
+public:
+    /**
+     * @param window_ns duration of the windows (remote time, nanoseconds)
+     * @param nb_windows number of windows used for the fit, between 1
+     * and TENNICAM_CLIENT_CLOCK_SYNC_MAX_WINDOWS
+     */
+    ClockSync(long int window_ns,
+              std::size_t nb_windows,
+              long int latency_ns,
+              long int reset_threshold_ns);
+    void reset();
+    /**
+     * @brief a frame with the time stamp remote (nanoseconds, clock of
+     * tennicam) has been received at local (nanoseconds, local clock).
+     * Returns true if the estimation changed.
+     */
+    bool add(long int remote, long int local);
+    const ClockOffset& get() const;
+
+private:
+    void fit();
+
+private:
+    long int window_ns_;
+    std::size_t nb_windows_;
+    long int latency_ns_;
+    long int reset_threshold_ns_;
+    // current window: start (remote time), and sample with the
+    // minimal delay
+    long int window_start_;
+    long int window_remote_;
+    long int window_delay_;
+    // minimal delays of the completed windows (ring buffer)
+    std::array<long int, TENNICAM_CLIENT_CLOCK_SYNC_MAX_WINDOWS> remotes_;
+    std::array<long int, TENNICAM_CLIENT_CLOCK_SYNC_MAX_WINDOWS> delays_;
+    std::size_t head_;
+    std::size_t size_;
+    ClockOffset offset_;
+};
+
+namespace internal
+{
+typedef Seqlock<ClockOffset> ClockOffsetRecord;
+}  // namespace internal
+
+/**
+ * @brief Reads the clock offset published by the driver of the
+ * tennicam_client standalone running with the same segment_id (the
+ * driver should be configured with clock synchronization). The shared
+ * memory segment is opened once, at construction.
+ */
+class ClockOffsetReader
+{
+public:
+    ClockOffsetReader(std::string segment_id);
+    ClockOffset get() const;
+
+private:
+    SharedRecord<internal::ClockOffsetRecord> record_;
+};
+
+/**
+ * @brief returns the latest clock offset published by the driver
+ * of the tennicam_client standalone running with the same segment_id
+ * (opens the shared memory segment at each call, see ClockOffsetReader).
+ */
+ClockOffset read_clock_offset(std::string segment_id);
+
+/**
+ * @brief id of the shared memory segment in which the driver
+ * associated to the segment_id writes its clock offset.
+ */
+std::string clock_offset_segment_id(const std::string& segment_id);
+
+}  // namespace tennicam_client
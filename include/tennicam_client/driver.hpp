@@ -12,9 +12,25 @@
 #include <zmqpp/zmqpp.hpp>
 #include "json_helper/json_helper.hpp"
 #include "o80/driver.hpp"
+#include "o80/time.hpp"
+#include "real_time_tools/thread.hpp"
 #include "tennicam_client/ball.hpp"
+#include "tennicam_client/clock_sync.hpp"
 #include "tennicam_client/driver_config.hpp"
+#include "tennicam_client/estimator.hpp"
+#include "tennicam_client/frame.hpp"
+#include "tennicam_client/frame_statistics.hpp"
+#include "tennicam_client/frame_parser.hpp"
+#include "tennicam_client/new_ball.hpp"
+#include "tennicam_client/outlier_gate.hpp"
+#include "tennicam_client/predictor.hpp"
+#include "tennicam_client/resampler.hpp"
+#include "tennicam_client/segmenter.hpp"
+#include "tennicam_client/spsc_queue.hpp"
+#include "tennicam_client/timings.hpp"
+#include "tennicam_client/tracker.hpp"
 #include "tennicam_client/transform.hpp"
+#include "tennicam_client/wire_format.hpp"
 
 namespace tennicam_client
 {
@@ -22,6 +38,26 @@ class DriverIn
 {
 };
 
+namespace internal
+{
+// item passed by the receive thread to Driver::get
+class ProcessedBall
+{
+public:
+    Ball ball;
+    // DriverConfig::multi_ball only
+    Balls balls;
+    StageTimings timings;
+    long int push_time_ns;
+};
+
+}  // namespace internal
+
+#define TENNICAM_CLIENT_RECEIVE_QUEUE_SIZE 256
+// initial capacity of the batch of balls read by Driver::get
+// (IngestionPolicy::ALL)
+#define TENNICAM_CLIENT_BATCH_CAPACITY 1024
+
 /**
  * @brief o80 drivers for tennicam (see:
  * https://github.com/intelligent-soft-robots/tennicam/), i.e. driver that
@@ -56,15 +92,22 @@ public:
      * for new transformation parameter, allowing for runtime tuning of the
      * transform, as described here:
      * https://intelligent-soft-robots.github.io/pam_documentation/C5_visual_ball_tracking.html#how-to-fix-the-transform-of-the-ball
-     * Note that this slows the driver down, so it is recommanded to call this
-     * constructor only if the transform requires to be tuned.
+     * The transform is written in a versioned shared memory record (see
+     * write_transform_to_memory), so checking for an update costs a single
+     * atomic load per iteration, and the transform is rebuilt only after
+     * the user wrote new values.
      */
     Driver(std::string toml_config_file,
            std::string active_transform_segment_id);
+    ~Driver();
     /**
      * @brief create the zmq socket required to connect with tennicam
+     * (and, if configured, starts the receive thread)
      */
     void start();
+    /**
+     * @brief stops the receive thread, if any
+     */
     void stop();
     /**
      * @brief Dummy function required by the o80::Driver interface
@@ -72,34 +115,255 @@ public:
     void set(const DriverIn&);
     /**
      * @brief read a ball information from tennicam, apply the transform,
-     * compute the ball velocity via finite differences and returns it   */
+     * compute the ball velocity via finite differences and returns it.
+     * In ReceiveMode::POLL, an invalid ball is returned if no new frame
+     * has been received before the configured timeout (see get_nb_stalls).
+     * If the driver is configured to use a receive thread (config io_thread),
+     * the frames are received and processed by this thread, and this
+     * method only returns the newest processed ball (or the previous ball
+     * again if no new frame has been processed since the last call).
+     * If configured (DriverConfig::latency_compensation), the returned
+     * ball (and the balls of the batch) are extrapolated to the current
+     * time (see compensate_latency).
+     * If configured (DriverConfig::resampling) and once set_frequency
+     * has been called, each call returns a new ball resampled from the
+     * observed ones (see Resampler), and the batch is empty.
+     * Invalid balls (returned or in the batch) carry the time stamp of
+     * the latest valid ball returned before them (-1 if none), so that
+     * the balls written in the o80 history are ordered by time stamps
+     * (see query_state).
+     */
     Ball get();
+    /**
+     * @brief extrapolates the ball from its time stamp to now plus
+     * DriverConfig::latency_compensation_extra_ms (nanoseconds, same
+     * clock as the time stamps of tennicam) and sets its compensated
+     * time stamp accordingly. Invalid balls, and balls older than
+     * DriverConfig::latency_compensation_max_ms, are not modified.
+     * Does nothing if the driver is not configured for latency
+     * compensation.
+     */
+    void compensate_latency(Ball& ball, long int now) const;
     const DriverConfig& get_config() const;
+    /**
+     * @brief number of times get() timed out waiting for a frame
+     * (ReceiveMode::POLL only)
+     */
+    long int get_nb_stalls() const;
+    /**
+     * @brief number of balls the receive thread could not pass
+     * to get() because the queue was full
+     */
+    long int get_nb_dropped() const;
+    /**
+     * @brief DriverConfig::multi_ball only: the balls of all the
+     * tracks (see MultiBallTracker), as of the last call to get()
+     * (invalid balls if not configured for multiple balls).
+     */
+    const Balls& get_balls() const;
+    /**
+     * @brief number of frames detected as outliers
+     * (see DriverConfig::gating)
+     */
+    long int get_nb_outliers() const;
+    /**
+     * @brief IngestionPolicy::ALL only: all the (new) balls read during the
+     * last call to get(), in order. The last ball of the batch is the one
+     * returned by get(). Empty if no new frame was available (get() then
+     * returned the previous ball again).
+     */
+    const std::vector<Ball>& get_batch() const;
+    /**
+     * @brief total number of frames discarded because more recent frames
+     * were available (IngestionPolicy::LATEST only)
+     */
+    long int get_nb_skipped_frames() const;
+    /**
+     * @brief statistics on the duration of each processing stage
+     */
+    const DriverTimings& get_timings() const;
+    /**
+     * @brief counters related to the frames received from tennicam
+     * (lost frames, duplicates, ...)
+     */
+    FrameStatistics get_frame_statistics() const;
+    /**
+     * @brief the frame statistics will be written in a dedicated
+     * shared memory segment (see read_frame_statistics), where they are
+     * updated at each frame. To be called before start.
+     */
+    void publish_frame_statistics(std::string segment_id);
+    /**
+     * @brief if the driver is configured with a predictor, writes
+     * a prediction for each new ball in the shared memory (see
+     * read_prediction)
+     */
+    void publish_prediction(std::string segment_id);
+    /**
+     * @brief each new (valid) ball returned by get will be written in
+     * the shared memory, waking up the processes waiting for it (see
+     * BallWaiter). To be called before start.
+     */
+    void publish_new_balls(std::string segment_id);
+    /**
+     * @brief if the driver is configured with clock synchronization,
+     * writes the estimated clock offset in the shared memory (see
+     * read_clock_offset). To be called before start.
+     */
+    void publish_clock_offset(std::string segment_id);
+    /**
+     * @brief estimated relation between the clock of tennicam and
+     * the local clock (DriverConfig::clock_sync)
+     */
+    ClockOffset get_clock_offset() const;
+    /**
+     * @brief frequency at which get is called. If the driver is
+     * configured with resampling, get then returns balls resampled at
+     * this frequency. Called by the standalone. To be called before
+     * start.
+     */
+    void set_frequency(double frequency);
     /**
      * @brief Activate the "active transform mode"
      */
     void set_active_config_read(std::string segment_id);
 
 private:
-    // compute the velocity using finite differences
+    // compute the velocity using the estimator
     std::array<double, 3> compute_velocity(
         long int time_stamp, const std::array<double, 3>& position);
+    // the next velocity estimation will not use the previous observations
+    void reset_velocity();
+    // the ball is no longer tracked (velocity estimation and outlier
+    // gate reset)
+    void reset_tracking();
+
+    // computes and writes a prediction if ball is a new ball
+    void update_prediction(const Ball& ball);
+    // invalid ball: sets its time stamp to latest_time_stamp_,
+    // valid ball: updates latest_time_stamp_
+    void stamp(Ball& ball);
+    // DriverConfig::clock_sync_rewrite: converts the time stamp
+    // of the ball to local time
+    void to_local_time(Ball& ball) const;
+    // updates the tracks with the balls detected in frame_
+    // (DriverConfig::multi_ball)
+    void update_tracks();
+    // rebuilds transform_ if a new transform has been written
+    // in the shared memory record since the last call
+    void update_active_transform();
+
+    // writes the next frame sent by tennicam in reply_, returns false
+    // if none could be received (ReceiveMode::POLL only)
+    bool receive();
+    // returns false if no message is pending
+    bool receive_pending();
+    bool receive_spin();
+    bool receive_poll(int timeout_ms);
+    // reads all pending messages, so that reply_ is the most recent one
+    // (IngestionPolicy::LATEST). Returns the number of skipped messages.
+    long int drain();
+
+    // parses the content of reply_ (json or binary) into frame_
+    void decode();
+    // generic (slower) json parsing, used for messages
+    // parse_json_frame does not support
+    void decode_json();
+
+    // transform, velocity estimation and ball instantiation
+    Ball process();
 
-    void init_active_transform_read() const;
+    // receive, decode and process the next frame. Returns false if
+    // nothing should be reported to the user (receive thread timing out
+    // while no timeout is configured, or, if pending_only is true, no
+    // message pending)
+    bool read_ball(Ball& ball, StageTimings& timings, bool pending_only);
+
+    // IngestionPolicy::ALL: reads all pending frames into batch_
+    Ball read_batch();
+
+    // get, without latency compensation
+    Ball fetch();
+
+public:
+    // loop of the receive thread
+    void run_receive_thread();
+
+private:
+    // pops all balls pushed by the receive thread
+    // and returns the newest one (all popped balls are added to batch_
+    // if IngestionPolicy::ALL)
+    Ball pop_ball();
 
 private:
     DriverConfig config_;
     Transform transform_;
+    std::unique_ptr<Estimator> estimator_;
+    std::optional<TrajectorySegmenter> segmenter_;
+    std::optional<OutlierGate> gate_;
+    std::optional<MultiBallTracker> tracker_;
     std::unique_ptr<zmq::context_t> context_;
     std::unique_ptr<zmq::socket_t> socket_;
     zmq::message_t reply_;
+    // false if reply_ is the same message as the one
+    // of the previous iteration (ReceiveMode::SPIN)
+    bool message_is_new_;
+    Frame frame_;
+    long int frame_nb_skipped_;
+    SequenceTracker sequence_tracker_;
     json_helper::Jsonhelper jh_;
     long int ball_id_;
     long int previous_time_stamp_;
+    // latest frame detected as outlier, and the ball returned for it
+    long int outlier_time_stamp_;
+    Ball outlier_ball_;
     std::array<double, 3> previous_position_;
     std::array<double, 3> previous_velocity_;
     bool active_transform_read_;
     std::string active_transform_segment_id_;
+    std::unique_ptr<SharedRecord<internal::TransformRecord>>
+        active_transform_;
+    // version of the record transform_ corresponds to
+    std::uint64_t active_transform_version_;
+    // points either to local_frame_statistics_ or
+    // to the shared memory record
+    internal::AtomicFrameStatistics local_frame_statistics_;
+    internal::AtomicFrameStatistics* frame_statistics_;
+    std::unique_ptr<SharedRecord<internal::AtomicFrameStatistics>>
+        shared_frame_statistics_;
+    DriverTimings timings_;
+    std::optional<ClockSync> clock_sync_;
+    // points either to local_clock_offset_ or to the shared memory
+    // record (read by get_clock_offset, possibly from another thread)
+    internal::ClockOffsetRecord local_clock_offset_;
+    internal::ClockOffsetRecord* clock_offset_;
+    std::unique_ptr<SharedRecord<internal::ClockOffsetRecord>>
+        shared_clock_offset_;
+    std::optional<Predictor> predictor_;
+    // used for latency compensation
+    std::optional<Predictor> extrapolator_;
+    std::optional<Resampler> resampler_;
+    Prediction prediction_;
+    std::unique_ptr<SharedRecord<internal::PredictionRecord>>
+        shared_prediction_;
+    // id of the latest ball written in shared_new_ball_
+    long int notified_ball_id_;
+    // time stamp of the latest valid ball returned by get (see stamp)
+    long int latest_time_stamp_;
+    std::unique_ptr<SharedRecord<internal::NewBallRecord>> shared_new_ball_;
+    // receive thread related attributes
+    typedef SpscQueue<internal::ProcessedBall,
+                      TENNICAM_CLIENT_RECEIVE_QUEUE_SIZE>
+        ReceiveQueue;
+    std::unique_ptr<ReceiveQueue> queue_;
+    std::atomic<bool> running_;
+    real_time_tools::RealTimeThread thread_;
+    // last ball(s) returned by get
+    Ball latest_ball_;
+    Balls balls_;
+    // balls_ before latency compensation
+    Balls raw_balls_;
+    std::vector<Ball> batch_;
 };
 
 }  // namespace tennicam_client
@@ -5,8 +5,88 @@
 #include <string>
 #include "tennicam_client/toml/toml.hpp"
 
+// lengths of the o80 history (number of iterations) the standalone
+// is available with (see DriverConfig::history_size)
+#define TENNICAM_CLIENT_HISTORY_SIZE_1K 1000
+#define TENNICAM_CLIENT_HISTORY_SIZE_10K 10000
+#define TENNICAM_CLIENT_HISTORY_SIZE_50K 50000
+#define TENNICAM_CLIENT_HISTORY_SIZE_500K 500000
+
 namespace tennicam_client
 {
+/**
+ * How the Driver waits for tennicam frames.
+ * SPIN: legacy behavior, i.e. non blocking reads in a busy loop until a first
+ * message has been received (the latest message is then returned again
+ * until a new one arrives).
+ * POLL: waits for a new message using zmq polling, with an (optional) short
+ * busy spin before blocking and a timeout after which an invalid ball is
+ * returned.
+ */
+enum class ReceiveMode
+{
+    SPIN,
+    POLL
+};
+
+/**
+ * returns the receive mode corresponding to the string ("spin" or "poll"),
+ * throws an std::invalid_argument exception for any other value.
+ */
+ReceiveMode to_receive_mode(const std::string& receive_mode);
+
+/**
+ * How many of the frames received since the previous call to Driver::get
+ * are used.
+ * SINGLE: legacy behavior, one frame is read per call (if tennicam
+ * publishes faster than Driver::get is called, frames get queued and the
+ * returned balls are increasingly outdated).
+ * LATEST: all pending frames are read and only the most recent one is
+ * used (the others are counted as skipped, see Ball::get_nb_skipped_frames).
+ * ALL: all pending frames are read and processed in order (see
+ * Driver::get_batch), so that the Standalone writes all of them in the o80
+ * history.
+ */
+enum class IngestionPolicy
+{
+    SINGLE,
+    LATEST,
+    ALL
+};
+
+/**
+ * returns the ingestion policy corresponding to the string ("single",
+ * "latest" or "all"), throws an std::invalid_argument exception for any
+ * other value.
+ */
+IngestionPolicy to_ingestion_policy(const std::string& ingestion_policy);
+
+/**
+ * throws an std::invalid_argument exception if the standalone can not be
+ * instantiated with this length of history (see DriverConfig::history_size)
+ */
+void check_history_size(int history_size);
+
+/**
+ * How the Driver estimates the velocity of the ball (see estimator.hpp).
+ * FINITE_DIFFERENCE: legacy behavior, two points finite difference.
+ * KALMAN: Kalman filter with a constant acceleration model.
+ * POLYNOMIAL: least squares polynomial fit over the latest observations.
+ */
+enum class EstimatorType
+{
+    FINITE_DIFFERENCE,
+    KALMAN,
+    POLYNOMIAL
+};
+
+/**
+ * returns the estimator type corresponding to the string
+ * ("finite_difference", "kalman" or "polynomial"), throws an
+ * std::invalid_argument exception for any other value.
+ */
+EstimatorType to_estimator_type(const std::string& estimator);
+
 /**
  * Class which encapsulates the configuration for a Driver,
  * i.e. hostname, port and transform.
@@ -32,12 +112,159 @@ public:
     int server_port;
     std::array<double, 3> translation;
     std::array<double, 3> rotation;
+    ReceiveMode receive_mode = ReceiveMode::SPIN;
+    // POLL mode only: maximum duration the driver waits for a new frame
+    // before returning an invalid ball (negative value: no timeout)
+    int receive_timeout_ms = 100;
+    // POLL mode only: duration of the busy spin performed before blocking
+    int receive_spin_us = 0;
+    // if true, frames are received and processed by a dedicated
+    // thread, optionally pinned to the cpu io_thread_cpu
+    bool io_thread = false;
+    int io_thread_cpu = -1;
+    IngestionPolicy ingestion_policy = IngestionPolicy::SINGLE;
+    // number of iterations kept in the o80 history by the standalone,
+    // one of the TENNICAM_CLIENT_HISTORY_SIZE_* values
+    int history_size = TENNICAM_CLIENT_HISTORY_SIZE_50K;
+    // if true, the python start_standalone starts a
+    // PublishOnChangeStandalone, i.e. a ball is written in the o80
+    // history only when a new ball is produced (instead of at a fixed
+    // frequency). Requires ReceiveMode::POLL with a non negative
+    // receive_timeout_ms, no io_thread and no resampling.
+    bool publish_on_change = false;
+    EstimatorType estimator = EstimatorType::FINITE_DIFFERENCE;
+    // KALMAN only: standard deviation of the observed positions (meters)
+    // and spectral density of the jerk ((m/s^3)^2/Hz)
+    double kalman_position_noise = 0.005;
+    double kalman_process_noise = 1000.;
+    // m/s^2, along -z of the transformed frame
+    double gravity = 9.81;
+    // POLYNOMIAL only: number of observations used and order
+    // of the polynomial (1 or 2)
+    int polynomial_window = 10;
+    int polynomial_order = 2;
+    // if true, the driver publishes in the shared memory a prediction
+    // of the flight of the ball (see Predictor), computed with
+    // prediction_drag (1/m) and gravity, over prediction_nb_steps steps
+    // of prediction_dt seconds, and with the crossing of the plane
+    // orthogonal to prediction_plane_axis (0: x, 1: y, 2: z)
+    // at prediction_plane_position
+    bool predictor = false;
+    double prediction_drag = 0.11;
+    double prediction_dt = 0.01;
+    int prediction_nb_steps = 50;
+    int prediction_plane_axis = 1;
+    double prediction_plane_position = 0.;
+    // if true, the driver splits the trajectory of the ball into
+    // segments at bounces and hits (see TrajectorySegmenter), and the
+    // velocity estimation restarts at the beginning of each segment
+    bool segmentation = false;
+    double segmentation_velocity_change = 2.;
+    int segmentation_hit_axis = 1;
+    // if true, observations inconsistent with the previous ones (see
+    // OutlierGate) are rejected (the previous ball is returned again)
+    // or, if gating_reject is false, returned with the OUTLIER flag.
+    // In both cases they are not used for the velocity estimation.
+    bool gating = false;
+    double gating_max_speed = 30.;
+    double gating_max_residual = 0.3;
+    int gating_max_consecutive_outliers = 5;
+    bool gating_reject = true;
+    // if true, Driver::get extrapolates the balls (gravity and
+    // drag, see Predictor) from their time stamp to the current time
+    // plus latency_compensation_extra_ms, i.e. to (about) the time
+    // they are read from the shared memory. Balls older than
+    // latency_compensation_max_ms (e.g. clocks of tennicam and of
+    // the driver not synchronized) are not extrapolated.
+    bool latency_compensation = false;
+    double latency_compensation_extra_ms = 0.;
+    double latency_compensation_max_ms = 50.;
+    // if true, the driver also associates all the detected balls to
+    // persistent tracks (see MultiBallTracker and Driver::get_balls),
+    // detections being associated only if closer than
+    // multi_ball_max_distance (meters) to the predicted position of
+    // a track, and tracks being closed after multi_ball_max_missed
+    // frames without associated detection
+    bool multi_ball = false;
+    double multi_ball_max_distance = 0.3;
+    int multi_ball_max_missed = 5;
+    // if true, the offset and drift between the clock of tennicam and
+    // the local clock are estimated from the minimal delays between
+    // frame time stamps and receive times over windows of
+    // clock_sync_window_ms (see ClockSync), and published by the
+    // standalone. clock_sync_latency_ms is the (known) minimal latency
+    // between tennicam and the driver. If clock_sync_rewrite is true,
+    // the time stamps of the balls are converted to local time.
+    bool clock_sync = false;
+    double clock_sync_window_ms = 1000.;
+    int clock_sync_nb_windows = 30;
+    double clock_sync_latency_ms = 0.;
+    double clock_sync_reset_threshold_ms = 20.;
+    bool clock_sync_rewrite = false;
+    // if true, the standalone writes at each iteration a new ball
+    // resampled at its own frequency (see Resampler): time stamps
+    // spaced by exactly one period, kept resampling_delay_ms behind
+    // the latest observation (interpolation), or predicted from it
+    // (at most resampling_max_extrapolation_ms ahead). The time
+    // stamps jump back to this target if they drift away by more
+    // than resampling_resync_ms.
+    bool resampling = false;
+    double resampling_delay_ms = 10.;
+    double resampling_max_extrapolation_ms = 50.;
+    double resampling_resync_ms = 20.;
 
 public:
     template <class Archive>
     void serialize(Archive& archive)
     {
-        archive(server_hostname, server_port, translation, rotation);
+        archive(server_hostname,
+                server_port,
+                translation,
+                rotation,
+                receive_mode,
+                receive_timeout_ms,
+                receive_spin_us,
+                io_thread,
+                io_thread_cpu,
+                ingestion_policy,
+                history_size,
+                publish_on_change,
+                estimator,
+                kalman_position_noise,
+                kalman_process_noise,
+                gravity,
+                polynomial_window,
+                polynomial_order,
+                predictor,
+                prediction_drag,
+                prediction_dt,
+                prediction_nb_steps,
+                prediction_plane_axis,
+                prediction_plane_position,
+                segmentation,
+                segmentation_velocity_change,
+                segmentation_hit_axis,
+                gating,
+                gating_max_speed,
+                gating_max_residual,
+                gating_max_consecutive_outliers,
+                gating_reject,
+                latency_compensation,
+                latency_compensation_extra_ms,
+                latency_compensation_max_ms,
+                multi_ball,
+                multi_ball_max_distance,
+                multi_ball_max_missed,
+                clock_sync,
+                clock_sync_window_ms,
+                clock_sync_nb_windows,
+                clock_sync_latency_ms,
+                clock_sync_reset_threshold_ms,
+                clock_sync_rewrite,
+                resampling,
+                resampling_delay_ms,
+                resampling_max_extrapolation_ms,
+                resampling_resync_ms);
     }
 };
 
@@ -52,7 +279,7 @@ DriverConfig parse_toml(const std::string& toml_config_file);
 /**
  * toml_config_file being an absolute path to a toml configuration file,
  * overwrite the translation and rotation attributes specified by the
- * configuration file.
+ * configuration file (all other entries are kept).
  */
 void update_transform_config_file(std::string file_path,
                                   const std::array<double, 3>& translation,
@@ -4,12 +4,14 @@
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <random>
 #include <zmq.hpp>
 #include <zmqpp/zmqpp.hpp>
 #include "json_helper/json_helper.hpp"
 #include "o80/time.hpp"
 #include "real_time_tools/thread.hpp"
 #include "tennicam_client/driver.hpp"
+#include "tennicam_client/wire_format.hpp"
 
 namespace tennicam_client
 {
@@ -23,10 +25,17 @@ class DummyServer
 public:
     /**
      * @brief Instantiate a DummyDriver using the hostname
-     * and port attributes of the configuration.
+     * and port attributes of the configuration. Balls are published
+     * at the given frequency, either as json formatted strings (as
+     * tennicam does) or as binary frames. The positions follow
+     * DummyServer::trajectory, with added gaussian noise of standard
+     * deviation position_noise (meters).
      */
 
-    DummyServer(const DriverConfig& config);
+    DummyServer(const DriverConfig& config,
+                WireFormat wire_format = WireFormat::JSON,
+                double frequency = 100.,
+                double position_noise = 0.);
     ~DummyServer();
     /**
      * @brief spawns a thread that publishes balls
@@ -37,6 +46,11 @@ public:
      */
     void stop();
     void run();
+    /**
+     * @brief (noise free) position of the ball published with the
+     * frame number num
+     */
+    static std::array<double, 3> trajectory(long int num);
 
 private:
     void perform(long int num, double x, double y, double z);
@@ -44,6 +58,11 @@ private:
 private:
     std::unique_ptr<zmqpp::context> context_;
     std::unique_ptr<zmqpp::socket> socket_;
+    WireFormat wire_format_;
+    std::chrono::nanoseconds period_;
+    std::mt19937 generator_;
+    std::normal_distribution<double> noise_;
+    bool noisy_;
     std::atomic<bool> running_;
     real_time_tools::RealTimeThread thread_;
 };
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include "tennicam_client/driver_config.hpp"
+
+// maximal number of observations used by PolynomialFit
+#define TENNICAM_CLIENT_POLYNOMIAL_MAX_WINDOW 64
+
+namespace tennicam_client
+{
+/**
+ * @brief Interface for the estimation of the ball velocity
+ * from successive (transformed) observed positions.
+ */
+class Estimator
+{
+public:
+    virtual ~Estimator()
+    {
+    }
+    /**
+     * @brief forgets all previous observations
+     * (e.g. the ball is no longer detected)
+     */
+    virtual void reset() = 0;
+    /**
+     * @brief returns the estimated velocity after the observation of
+     * position at time_stamp (nanoseconds). Time stamps are expected
+     * to be increasing, but the implementations should not fail
+     * otherwise (e.g. timing jitter).
+     */
+    virtual std::array<double, 3> update(
+        long int time_stamp, const std::array<double, 3>& position) = 0;
+};
+
+/**
+ * @brief Two points finite difference (legacy behavior). If the time
+ * stamp did not increase, the previous velocity is returned.
+ */
+class FiniteDifference : public Estimator
+{
+public:
+    FiniteDifference();
+    void reset();
+    std::array<double, 3> update(long int time_stamp,
+                                 const std::array<double, 3>& position);
+
+private:
+    long int previous_time_stamp_;
+    std::array<double, 3> previous_position_;
+    std::array<double, 3> velocity_;
+};
+
+/**
+ * @brief Kalman filter using a constant acceleration model (i.e. the
+ * jerk is white noise), one independent filter per axis. The acceleration
+ * is initialized to gravity (along -z), so that the filter does not have
+ * to learn it at the start of each trajectory. Does not allocate memory.
+ */
+class KalmanFilter : public Estimator
+{
+public:
+    /**
+     * @param position_noise standard deviation of the observed
+     * positions (meters)
+     * @param process_noise spectral density of the jerk
+     * ((m/s^3)^2/Hz)
+     * @param gravity (m/s^2, along -z)
+     */
+    KalmanFilter(double position_noise, double process_noise, double gravity);
+    void reset();
+    std::array<double, 3> update(long int time_stamp,
+                                 const std::array<double, 3>& position);
+    /**
+     * @brief filtered position
+     */
+    std::array<double, 3> get_position() const;
+    std::array<double, 3> get_velocity() const;
+    std::array<double, 3> get_acceleration() const;
+
+private:
+    typedef std::array<double, 3> State;  // position, velocity, acceleration
+    typedef std::array<std::array<double, 3>, 3> Covariance;
+    void predict(double dt);
+    void correct(const std::array<double, 3>& position);
+
+private:
+    double position_variance_;
+    double process_noise_;
+    double gravity_;
+    long int previous_time_stamp_;
+    std::array<State, 3> x_;
+    std::array<Covariance, 3> p_;
+};
+
+/**
+ * @brief Least squares fit of a polynomial (order 1 or 2) over the
+ * positions observed during the last window frames (time stamps do not
+ * need to be equally spaced), the velocity being the derivative of the
+ * polynomial at the latest observation.
+ * The observations are kept in a fixed size ring buffer, and the sums
+ * used by the normal equations are updated when an observation is
+ * added / removed, so the cost of an update does not depend on the size
+ * of the window (except for the recomputation of the sums every window
+ * updates, which bounds the accumulation of rounding errors).
+ */
+class PolynomialFit : public Estimator
+{
+public:
+    /**
+     * @param window number of observations used, between order+1 and
+     * TENNICAM_CLIENT_POLYNOMIAL_MAX_WINDOW
+     * @param order 1 (linear, i.e. constant velocity) or 2 (quadratic,
+     * i.e. constant acceleration)
+     */
+    PolynomialFit(int window, int order);
+    void reset();
+    std::array<double, 3> update(long int time_stamp,
+                                 const std::array<double, 3>& position);
+    std::array<double, 3> get_velocity() const;
+    // null for order 1
+    std::array<double, 3> get_acceleration() const;
+
+private:
+    // adds (sign=1) or removes (sign=-1) the observation
+    // at the index of the ring to/from the sums
+    void add(std::size_t index, double sign);
+    // uses the latest time stamp as time reference and recomputes
+    // the sums
+    void rebase();
+    void fit();
+
+private:
+    std::size_t window_;
+    int order_;
+    std::array<long int, TENNICAM_CLIENT_POLYNOMIAL_MAX_WINDOW> time_stamps_;
+    std::array<std::array<double, 3>, TENNICAM_CLIENT_POLYNOMIAL_MAX_WINDOW>
+        positions_;
+    // index of the next observation in the ring
+    std::size_t head_;
+    std::size_t size_;
+    std::size_t nb_updates_;
+    long int reference_time_stamp_;
+    // sums of tau^k and of tau^k * position (per axis), tau
+    // being the time (seconds) relative to reference_time_stamp_
+    std::array<double, 5> tau_sums_;
+    std::array<std::array<double, 3>, 3> position_sums_;
+    std::array<double, 3> velocity_;
+    std::array<double, 3> acceleration_;
+};
+
+/**
+ * @brief returns the estimator selected by the configuration
+ */
+std::unique_ptr<Estimator> create_estimator(const DriverConfig& config);
+
+}  // namespace tennicam_client
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// maximal number of detections per frame (additional
+// detections are ignored)
+#define TENNICAM_CLIENT_MAX_DETECTIONS 16
+
+namespace tennicam_client
+{
+/**
+ * @brief Content of a message sent by tennicam, i.e.
+ * frame number, time stamps and (if any) positions
+ * of the detected balls (in the camera frame).
+ */
+class Frame
+{
+public:
+    Frame();
+
+public:
+    // frame number, increased by one by tennicam for each frame
+    long int num;
+    // time stamp (nanoseconds)
+    long int time_stamp;
+    // processing time reported by tennicam
+    double proc_time;
+    // false if the ball was not detected
+    // (i.e. "obs" was null)
+    bool detected;
+    // position of the (first) detected ball
+    std::array<double, 3> position;
+    // all detected balls ("obs" being a list of positions),
+    // detections[0] being the same as position
+    std::size_t nb_detections;
+    std::array<std::array<double, 3>, TENNICAM_CLIENT_MAX_DETECTIONS>
+        detections;
+};
+
+}  // namespace tennicam_client
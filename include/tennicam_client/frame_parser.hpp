@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include "tennicam_client/frame.hpp"
+
+namespace tennicam_client
+{
+/**
+ * @brief Parses a json formatted tennicam message, expected to be an object
+ * with the keys "num", "time", "proc_time" (optional) and "obs", obs being
+ * either null, an array of 3 numbers or (several balls detected) an
+ * array of arrays of 3 numbers, e.g.
+ * {"num":12,"obs":[0.1,0.2,0.3],"proc_time":1,"time":1654012345678}
+ * {"num":13,"obs":[[0.1,0.2,0.3],[1,2,3]],"proc_time":1,"time":1654012345679}
+ * The parsing is performed directly on the buffer (no copy, no
+ * memory allocation). Returns false if the message does not have the
+ * expected layout (e.g. unknown keys or escaped strings), in which case
+ * the content of frame is undefined and a generic json parser should be
+ * used instead.
+ */
+bool parse_json_frame(const char* data, std::size_t size, Frame& frame);
+
+}  // namespace tennicam_client
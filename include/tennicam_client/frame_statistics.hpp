@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include "tennicam_client/shared_record.hpp"
+
+namespace tennicam_client
+{
+/**
+ * @brief Counters related to the frames received from tennicam.
+ * The sequence related counters (lost frames, gaps, duplicates,
+ * reorderings) are computed from the frame number ("num") sent
+ * by tennicam, which is expected to increase by one for each frame.
+ */
+class FrameStatistics
+{
+public:
+    FrameStatistics();
+    std::string to_string() const;
+
+public:
+    // number of frames received
+    long int nb_frames;
+    // frame number of the last frame received
+    long int last_num;
+    // number of frames never received (sum of the sizes of the gaps)
+    long int nb_lost_frames;
+    // number of times at least one frame was missing
+    long int nb_gaps;
+    // number of frames received with the same number as the previous one
+    long int nb_duplicates;
+    // number of frames received with a number lower than the previous one
+    long int nb_reordered;
+    // see Driver::get_nb_skipped_frames
+    long int nb_skipped_frames;
+    // see Driver::get_nb_stalls
+    long int nb_stalls;
+    // see Driver::get_nb_dropped
+    long int nb_dropped;
+    // see Driver::get_nb_outliers
+    long int nb_outliers;
+};
+
+/**
+ * @brief Keeps track of the frame numbers sent by tennicam
+ */
+class SequenceTracker
+{
+public:
+    enum Event
+    {
+        FIRST,
+        IN_ORDER,
+        GAP,
+        DUPLICATE,
+        REORDERED
+    };
+
+public:
+    SequenceTracker();
+    /**
+     * @brief update the tracker with a newly received frame number,
+     * returns how it relates to the previous ones. nb_skipped is the number
+     * of frames received just before this one but discarded without being
+     * parsed (see IngestionPolicy::LATEST), which are not counted as lost.
+     * In case of GAP, nb_lost is set to the number of missing frames.
+     */
+    Event update(long int num, long int nb_skipped, long int& nb_lost);
+
+private:
+    long int last_num_;
+};
+
+namespace internal
+{
+// FrameStatistics, which may be written / read concurrently
+// (possibly by different processes, see SharedRecord)
+class AtomicFrameStatistics
+{
+public:
+    AtomicFrameStatistics();
+    // update the counters according to the event
+    void add(SequenceTracker::Event event, long int num, long int nb_lost);
+    FrameStatistics get() const;
+
+public:
+    std::atomic<long int> nb_frames;
+    std::atomic<long int> last_num;
+    std::atomic<long int> nb_lost_frames;
+    std::atomic<long int> nb_gaps;
+    std::atomic<long int> nb_duplicates;
+    std::atomic<long int> nb_reordered;
+    std::atomic<long int> nb_skipped_frames;
+    std::atomic<long int> nb_stalls;
+    std::atomic<long int> nb_dropped;
+    std::atomic<long int> nb_outliers;
+};
+
+}  // namespace internal
+
+/**
+ * @brief Reads the statistics published by the driver of the
+ * tennicam_client standalone running with the same segment_id.
+ * The shared memory segment is opened once, at construction, so that
+ * get can be called at each iteration of a control loop (it only
+ * loads the counters).
+ */
+class FrameStatisticsReader
+{
+public:
+    FrameStatisticsReader(std::string segment_id);
+    FrameStatistics get() const;
+
+private:
+    SharedRecord<internal::AtomicFrameStatistics> record_;
+};
+
+/**
+ * @brief returns the statistics published by the driver of the
+ * tennicam_client standalone running with the same segment_id
+ * (opens the shared memory segment at each call, see
+ * FrameStatisticsReader).
+ */
+FrameStatistics read_frame_statistics(std::string segment_id);
+
+/**
+ * @brief id of the shared memory segment in which the driver
+ * associated to the segment_id writes its statistics.
+ */
+std::string frame_statistics_segment_id(const std::string& segment_id);
+
+}  // namespace tennicam_client
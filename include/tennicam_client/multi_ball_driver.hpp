@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdexcept>
+#include "o80/driver.hpp"
+#include "tennicam_client/driver.hpp"
+#include "tennicam_client/tracker.hpp"
+
+namespace tennicam_client
+{
+/**
+ * @brief o80 driver returning the balls of all the tracks (see
+ * MultiBallTracker), i.e. one ball per dof of the MultiBallStandalone.
+ * Wraps a Driver (same configuration file), which should be configured
+ * for multiple balls (DriverConfig::multi_ball), otherwise an
+ * std::invalid_argument exception is thrown.
+ */
+class MultiBallDriver : public o80::Driver<DriverIn, Balls>
+{
+public:
+    MultiBallDriver(const DriverConfig& config);
+    MultiBallDriver(std::string toml_config_file);
+    MultiBallDriver(std::string toml_config_file,
+                    std::string active_transform_segment_id);
+    void start();
+    void stop();
+    void set(const DriverIn&);
+    Balls get();
+    // (o80::Driver being a base class, Driver refers to it here)
+    tennicam_client::Driver& get_driver();
+
+private:
+    void check_config() const;
+
+private:
+    tennicam_client::Driver driver_;
+};
+
+}  // namespace tennicam_client
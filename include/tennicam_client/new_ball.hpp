@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "tennicam_client/ball.hpp"
+#include "tennicam_client/ball_record.hpp"
+#include "tennicam_client/seqlock.hpp"
+#include "tennicam_client/shared_record.hpp"
+
+namespace tennicam_client
+{
+namespace internal
+{
+/**
+ * @brief Latest new ball produced by the driver, and futex word
+ * incremented at each new ball (see BallWaiter)
+ */
+class NewBallRecord
+{
+public:
+    NewBallRecord();
+
+public:
+    std::atomic<std::uint32_t> sequence;
+    // number of processes currently waiting on sequence (the
+    // writer skips the wake up system call if none)
+    std::atomic<std::uint32_t> nb_waiters;
+    Seqlock<BallRecord> ball;
+};
+
+/**
+ * @brief blocks while the futex word is equal to expected, for at most
+ * timeout_ns nanoseconds (the word may live in shared memory)
+ */
+void futex_wait(std::atomic<std::uint32_t>& word,
+                std::uint32_t expected,
+                long int timeout_ns);
+/**
+ * @brief wakes all the threads / processes blocked in futex_wait
+ * on the word
+ */
+void futex_wake(std::atomic<std::uint32_t>& word);
+
+/**
+ * @brief writes the ball in the record and wakes the waiting processes
+ */
+void notify_new_ball(NewBallRecord& record, const Ball& ball);
+
+}  // namespace internal
+
+/**
+ * @brief Waits for the new balls produced by the driver of the
+ * tennicam_client standalone running with the same segment_id, i.e.
+ * blocks (without using the CPU) until the driver produces a ball with a
+ * new ball id (invalid balls, i.e. ball not detected, do not wake up the
+ * waiters). The waiters are woken as soon as the driver returns the
+ * ball, i.e. just before it is written in the o80 history.
+ */
+class BallWaiter
+{
+public:
+    BallWaiter(std::string segment_id);
+    /**
+     * @brief waits for a ball with an id different from the one of the
+     * ball returned by the previous call (or, for the first call, of the
+     * latest ball when the waiter was constructed). Returns false if no
+     * such ball was produced within timeout_us microseconds.
+     */
+    bool wait(long int timeout_us, Ball& ball);
+    /**
+     * @brief latest new ball produced by the driver (invalid ball if
+     * none yet)
+     */
+    Ball latest() const;
+
+private:
+    SharedRecord<internal::NewBallRecord> record_;
+    long int ball_id_;
+};
+
+/**
+ * @brief id of the shared memory segment in which the driver associated
+ * to the segment_id writes its new balls (see BallWaiter)
+ */
+std::string new_ball_segment_id(const std::string& segment_id);
+
+}  // namespace tennicam_client
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+namespace tennicam_client
+{
+/**
+ * @brief Detects observed positions inconsistent with the previously
+ * accepted ones (e.g. false detections by tennicam), either because:
+ * - reaching them would require a speed above max_speed (m/s), or
+ * - they are further than max_residual (m) from the position predicted
+ *   from the previous accepted position and velocity (constant velocity,
+ *   plus gravity along -z).
+ * A check is disabled if its bound is not positive.
+ * After max_consecutive_outliers successive outliers, the gate assumes
+ * the previous observations were wrong (or the ball changed) and
+ * restarts from the new observation. Constant cost, no allocation.
+ */
+class OutlierGate
+{
+public:
+    enum Result
+    {
+        ACCEPTED,
+        OUTLIER,
+        // accepted, but inconsistent with the previous observations,
+        // which should no longer be used
+        RESTARTED
+    };
+
+public:
+    OutlierGate(double max_speed,
+                double max_residual,
+                int max_consecutive_outliers,
+                double gravity);
+    /**
+     * @brief the next observation will be accepted
+     * (e.g. the ball is no longer detected)
+     */
+    void reset();
+    Result check(long int time_stamp, const std::array<double, 3>& position);
+    /**
+     * @brief velocity estimated at the latest accepted observation,
+     * used to predict the next position
+     */
+    void set_velocity(const std::array<double, 3>& velocity);
+
+private:
+    void accept(long int time_stamp, const std::array<double, 3>& position);
+
+private:
+    double max_speed_;
+    double max_residual_;
+    int max_consecutive_outliers_;
+    double gravity_;
+    // number of accepted observations since the latest reset (up to 2)
+    int nb_accepted_;
+    int nb_consecutive_outliers_;
+    long int time_stamp_;
+    std::array<double, 3> position_;
+    std::array<double, 3> velocity_;
+};
+
+}  // namespace tennicam_client
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "tennicam_client/ball.hpp"
+#include "tennicam_client/seqlock.hpp"
+#include "tennicam_client/shared_record.hpp"
+
+// maximal number of future states of a Prediction
+#define TENNICAM_CLIENT_PREDICTION_MAX_STEPS 50
+// maximal integration step of Predictor (seconds)
+#define TENNICAM_CLIENT_PREDICTION_MAX_SUBSTEP 0.002
+
+namespace tennicam_client
+{
+/**
+ * @brief Predicted future states of a ball, see Predictor.
+ */
+class Prediction
+{
+public:
+    Prediction();
+    std::string to_string() const;
+
+public:
+    // id of the ball the prediction starts from (-1: no prediction,
+    // e.g. the ball is not detected)
+    long int ball_id;
+    // time stamp of this ball (nanoseconds)
+    long int time_stamp;
+    // duration between two predicted states (seconds)
+    double dt;
+    int nb_steps;
+    // states at time_stamp + (index+1)*dt, index < nb_steps
+    std::array<std::array<double, 3>, TENNICAM_CLIENT_PREDICTION_MAX_STEPS>
+        positions;
+    std::array<std::array<double, 3>, TENNICAM_CLIENT_PREDICTION_MAX_STEPS>
+        velocities;
+    // true if the ball crosses the plane (see Predictor) within
+    // nb_steps*dt seconds
+    bool crosses_plane;
+    // seconds after time_stamp
+    double plane_time;
+    std::array<double, 3> plane_position;
+    std::array<double, 3> plane_velocity;
+};
+
+/**
+ * @brief Predicts the flight of a ball from its current position and
+ * velocity, accounting for gravity (along -z) and quadratic air drag
+ * (acceleration: -drag * |v| * v), using Runge-Kutta 4 integration.
+ * Also computes when the ball crosses the plane orthogonal to
+ * plane_axis (0: x, 1: y, 2: z) at plane_position.
+ */
+class Predictor
+{
+public:
+    Predictor(double gravity,
+              double drag,
+              double dt,
+              int nb_steps,
+              int plane_axis,
+              double plane_position);
+    void predict(const Ball& ball, Prediction& prediction) const;
+    // integrates (in place) position and velocity over duration
+    void integrate(std::array<double, 3>& position,
+                   std::array<double, 3>& velocity,
+                   double duration) const;
+
+private:
+    std::array<double, 3> acceleration(
+        const std::array<double, 3>& velocity) const;
+    void step(std::array<double, 3>& position,
+              std::array<double, 3>& velocity,
+              double h) const;
+
+private:
+    double gravity_;
+    double drag_;
+    double dt_;
+    int nb_steps_;
+    int nb_substeps_;
+    int plane_axis_;
+    double plane_position_;
+};
+
+namespace internal
+{
+typedef Seqlock<Prediction> PredictionRecord;
+}  // namespace internal
+
+/**
+ * @brief Reads the predictions published by the driver of the
+ * tennicam_client standalone running with the same segment_id (the
+ * driver should be configured with a predictor). The shared memory
+ * segment is opened once, at construction.
+ */
+class PredictionReader
+{
+public:
+    PredictionReader(std::string segment_id);
+    /**
+     * @brief latest prediction
+     */
+    Prediction get() const;
+    /**
+     * @brief writes the latest prediction into prediction
+     */
+    void read(Prediction& prediction) const;
+
+private:
+    SharedRecord<internal::PredictionRecord> record_;
+};
+
+/**
+ * @brief returns the latest prediction published by the driver
+ * of the tennicam_client standalone running with the same segment_id
+ * (opens the shared memory segment at each call, see PredictionReader).
+ */
+Prediction read_prediction(std::string segment_id);
+
+/**
+ * @brief id of the shared memory segment in which the driver
+ * associated to the segment_id writes its predictions.
+ */
+std::string prediction_segment_id(const std::string& segment_id);
+
+}  // namespace tennicam_client
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include "tennicam_client/ball.hpp"
+
+// number of observations kept by Resampler
+#define TENNICAM_CLIENT_RESAMPLING_HISTORY 16
+
+namespace tennicam_client
+{
+/**
+ * @brief Resamples the (irregular) stream of observed balls at a fixed
+ * frequency: each call to sample returns a new ball (new ball id), with
+ * a time stamp increased by exactly 1/frequency, and a state interpolated
+ * (cubic Hermite) between the observations or, if more recent than the
+ * latest observation, predicted (gravity only) from it.
+ * The time stamps (same clock as the observations) are kept about
+ * delay behind the latest observation, so that with a delay larger
+ * than the interval between frames, the balls are interpolated. If the
+ * time stamps drift away from this target by more than resync (e.g. the
+ * caller does not run exactly at frequency), they jump back to it.
+ * Invalid balls are returned when the ball is lost, or if the time stamp
+ * is more than max_extrapolation after the latest observation.
+ * The events (see Ball::get_events) and skipped frames of the
+ * observations added since the previous (valid) sample are reported
+ * by the next valid sample.
+ * The output only depends on the observations and the number of calls
+ * to sample (no clock is read). No memory allocation, constant cost.
+ * (all durations in seconds)
+ */
+class Resampler
+{
+public:
+    Resampler(double frequency,
+              double delay,
+              double max_extrapolation,
+              double resync,
+              double gravity);
+    /**
+     * @brief the next sample will be (re)synchronized with the next
+     * observation
+     */
+    void reset();
+    /**
+     * @brief a ball returned by the driver (the same ball may be added
+     * several times). An invalid ball (ball lost) resets the resampler.
+     */
+    void add(const Ball& ball);
+    /**
+     * @brief the ball at the next tick (invalid ball if none
+     * observed yet, or ball lost)
+     */
+    Ball sample();
+
+private:
+    const Ball& observation(std::size_t age) const;
+
+private:
+    double period_ns_;
+    long int delay_ns_;
+    long int max_extrapolation_ns_;
+    long int resync_ns_;
+    double gravity_;
+    // observations (ring buffer)
+    std::array<Ball, TENNICAM_CLIENT_RESAMPLING_HISTORY> observations_;
+    std::size_t head_;
+    std::size_t size_;
+    bool new_observation_;
+    // events and skipped frames of the observations not yet
+    // reported by a sample
+    int pending_events_;
+    long int pending_nb_skipped_frames_;
+    bool anchored_;
+    long int origin_;
+    long int tick_;
+    long int ball_id_;
+};
+
+}  // namespace tennicam_client
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <stdexcept>
+#include "tennicam_client/ball.hpp"
+
+namespace tennicam_client
+{
+/**
+ * @brief Splits the stream of observed (transformed) positions into
+ * trajectory segments, a new segment starting at each bounce or hit
+ * (see BallEvent), or when the ball is detected again after having
+ * been lost (see reset).
+ * Bounces and hits are detected from the velocities (finite
+ * differences) before and after each observation: the velocity should
+ * change by more than velocity_change_threshold (m/s), and either
+ * the vertical velocity changes from downward to upward (bounce), or
+ * the velocity along hit_axis (0: x, 1: y, 2: z) changes sign (hit).
+ * As the velocity after an observation is known only at the next
+ * observation, the events are reported one observation late (i.e. the
+ * observation at which the bounce occurred is the last one of the
+ * previous segment). Constant cost per observation.
+ */
+class TrajectorySegmenter
+{
+public:
+    TrajectorySegmenter(double velocity_change_threshold, int hit_axis);
+    /**
+     * @brief the next observation will start a new segment
+     */
+    void reset();
+    /**
+     * @brief returns the events (BallEvent flags) detected
+     * at this observation
+     */
+    int update(long int time_stamp, const std::array<double, 3>& position);
+    long int get_segment_id() const;
+
+private:
+    double velocity_change_threshold_;
+    int hit_axis_;
+    long int segment_id_;
+    // number of observations of the current segment (up to 2)
+    int nb_observations_;
+    long int previous_time_stamp_;
+    std::array<double, 3> previous_position_;
+    // velocity between the two latest observations
+    std::array<double, 3> previous_velocity_;
+};
+
+}  // namespace tennicam_client
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace tennicam_client
+{
+/**
+ * @brief An instance of T which may be written / read concurrently,
+ * including by different processes if the Seqlock lives in shared
+ * memory (see SharedRecord). Writers are mutually excluded; readers
+ * do not block writers and retry if a write occurred while reading.
+ * The version increases (by 2) at each write, so readers may check
+ * for changes with a single atomic load.
+ */
+template <class T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Seqlock requires a trivially copyable type");
+
+public:
+    Seqlock() : version_{0}
+    {
+        for (std::atomic<std::uint64_t>& word : words_)
+        {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void write(const T& value)
+    {
+        std::uint64_t buffer[NB_WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        // making the version odd, waiting for concurrent writers (if any)
+        std::uint64_t version = version_.load(std::memory_order_relaxed);
+        while (version % 2 == 1 ||
+               !version_.compare_exchange_weak(
+                   version, version + 1, std::memory_order_relaxed))
+        {
+            version = version_.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t index = 0; index < NB_WORDS; index++)
+        {
+            words_[index].store(buffer[index], std::memory_order_relaxed);
+        }
+        version_.store(version + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief returns the version of the value read
+     * (0: never written)
+     */
+    std::uint64_t read(T& value) const
+    {
+        std::uint64_t buffer[NB_WORDS];
+        while (true)
+        {
+            std::uint64_t version = version_.load(std::memory_order_acquire);
+            if (version % 2 == 1)
+            {
+                continue;
+            }
+            for (std::size_t index = 0; index < NB_WORDS; index++)
+            {
+                buffer[index] = words_[index].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version_.load(std::memory_order_relaxed) == version)
+            {
+                std::memcpy(&value, buffer, sizeof(T));
+                return version;
+            }
+        }
+    }
+
+    /**
+     * @brief odd while a write is ongoing
+     */
+    std::uint64_t get_version() const
+    {
+        return version_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr std::size_t NB_WORDS =
+        (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+    std::atomic<std::uint64_t> version_;
+    std::atomic<std::uint64_t> words_[NB_WORDS];
+};
+
+}  // namespace tennicam_client
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <string>
+
+namespace tennicam_client
+{
+/**
+ * @brief how a SharedRecord accesses its segment:
+ * CREATE: the segment is created (any previously existing segment with
+ * the same id is deleted);
+ * OPEN: an existing segment is opened
+ * (boost::interprocess::interprocess_exception is thrown if it does
+ * not exist);
+ * OPEN_OR_CREATE: an existing segment is opened, or created if none.
+ */
+enum class SharedRecordMode
+{
+    CREATE,
+    OPEN,
+    OPEN_OR_CREATE
+};
+
+/**
+ * @brief An instance of T living in its own shared memory segment,
+ * accessed directly (i.e. without serialization). T is expected to
+ * be a standard layout class whose members are either trivially copyable
+ * or lock free atomics, so that the record can be read and written
+ * concurrently by several processes.
+ */
+template <class T>
+class SharedRecord
+{
+public:
+    SharedRecord(const std::string& segment_id, SharedRecordMode mode)
+        : segment_{open_segment(segment_id, mode)},
+          record_{segment_.template find_or_construct<T>("record")()}
+    {
+    }
+
+    T& get()
+    {
+        return *record_;
+    }
+
+    const T& get() const
+    {
+        return *record_;
+    }
+
+    /**
+     * @brief deletes the shared memory segment
+     */
+    static void clear(const std::string& segment_id)
+    {
+        boost::interprocess::shared_memory_object::remove(segment_id.c_str());
+    }
+
+private:
+    static boost::interprocess::managed_shared_memory open_segment(
+        const std::string& segment_id, SharedRecordMode mode)
+    {
+        // some room for the segment own book keeping
+        constexpr std::size_t size = sizeof(T) + 4096;
+        switch (mode)
+        {
+            case SharedRecordMode::CREATE:
+                clear(segment_id);
+                return boost::interprocess::managed_shared_memory(
+                    boost::interprocess::create_only, segment_id.c_str(), size);
+            case SharedRecordMode::OPEN_OR_CREATE:
+                return boost::interprocess::managed_shared_memory(
+                    boost::interprocess::open_or_create,
+                    segment_id.c_str(),
+                    size);
+            default:
+                return boost::interprocess::managed_shared_memory(
+                    boost::interprocess::open_only, segment_id.c_str());
+        }
+    }
+
+private:
+    boost::interprocess::managed_shared_memory segment_;
+    T* record_;
+};
+
+}  // namespace tennicam_client
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace tennicam_client
+{
+/**
+ * @brief Lock free, fixed capacity, single producer / single consumer
+ * queue. push may be called by one thread and pop by another one
+ * without further synchronization.
+ * @tparam CAPACITY: maximum number of items in the queue, must be
+ * a power of 2.
+ */
+template <class T, std::size_t CAPACITY>
+class SpscQueue
+{
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "SpscQueue: CAPACITY must be a power of 2");
+
+public:
+    SpscQueue() : head_{0}, tail_{0}
+    {
+    }
+
+    /**
+     * @brief adds a copy of the item to the queue (producer thread only).
+     * Returns false (and does not add the item) if the queue is full.
+     */
+    bool push(const T& item)
+    {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == CAPACITY)
+        {
+            return false;
+        }
+        buffer_[tail & (CAPACITY - 1)] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief writes the oldest item of the queue into item and removes
+     * it from the queue (consumer thread only). Returns false if the queue
+     * is empty.
+     */
+    bool pop(T& item)
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = buffer_[head & (CAPACITY - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief number of items in the queue (only an approximation
+     * if the other thread is concurrently pushing or poping)
+     */
+    std::size_t size() const
+    {
+        return tail_.load(std::memory_order_acquire) -
+               head_.load(std::memory_order_acquire);
+    }
+
+private:
+    // head_ and tail_ on different cache lines, to avoid
+    // false sharing between the producer and the consumer
+    alignas(64) std::atomic<std::size_t> head_;
+    alignas(64) std::atomic<std::size_t> tail_;
+    alignas(64) std::array<T, CAPACITY> buffer_;
+};
+
+}  // namespace tennicam_client
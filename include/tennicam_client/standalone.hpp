@@ -1,11 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
 #include "o80/memory_clearing.hpp"
 #include "o80/standalone.hpp"
 #include "tennicam_client/ball.hpp"
 #include "tennicam_client/driver.hpp"
+#include "tennicam_client/multi_ball_driver.hpp"
+#include "tennicam_client/shared_record.hpp"
 
-#define TENNICAM_CLIENT_QUEUE_SIZE 50000
+// default length of the o80 history (see DriverConfig::history_size)
+#define TENNICAM_CLIENT_QUEUE_SIZE TENNICAM_CLIENT_HISTORY_SIZE_50K
 
 namespace tennicam_client
 {
@@ -14,20 +21,147 @@ namespace tennicam_client
  * an instance of Standalone will instantiate an instance of
  * o80 backend that will subscribe to tennicam and write
  * corresponding ball information in the shared memory.
+ * If the driver is configured with IngestionPolicy::ALL, all the
+ * balls read by the driver during an iteration are written
+ * (in order) in the o80 history.
+ * QUEUE_SIZE is the length of the o80 history, which is published
+ * (see read_history_size) so that consumers can instantiate the
+ * corresponding frontend. Instantiated for the lengths
+ * TENNICAM_CLIENT_HISTORY_SIZE_* only (see the typedefs below).
  */
-class Standalone
-    : public o80::Standalone<TENNICAM_CLIENT_QUEUE_SIZE,  // Queue size
-                             1,                           // nb dofs
+template <int QUEUE_SIZE>
+class StandaloneT
+    : public o80::Standalone<QUEUE_SIZE,  // Queue size
+                             1,           // nb dofs
                              Driver,
                              Ball,                    // o80 observation
                              o80::VoidExtendedState>  // no info on top of obs
 {
 public:
-    Standalone(std::shared_ptr<Driver> driver_ptr,
-               double frequency,
-               std::string segment_id);
+    StandaloneT(std::shared_ptr<Driver> driver_ptr,
+                double frequency,
+                std::string segment_id);
     o80::States<1, Ball> convert(const Ball& ball);
     DriverIn convert(const o80::States<1, Ball>&);
 };
 
+typedef StandaloneT<TENNICAM_CLIENT_QUEUE_SIZE> Standalone;
+typedef StandaloneT<TENNICAM_CLIENT_HISTORY_SIZE_1K> Standalone1k;
+typedef StandaloneT<TENNICAM_CLIENT_HISTORY_SIZE_10K> Standalone10k;
+typedef StandaloneT<TENNICAM_CLIENT_HISTORY_SIZE_500K> Standalone500k;
+
+extern template class StandaloneT<TENNICAM_CLIENT_HISTORY_SIZE_1K>;
+extern template class StandaloneT<TENNICAM_CLIENT_HISTORY_SIZE_10K>;
+extern template class StandaloneT<TENNICAM_CLIENT_HISTORY_SIZE_50K>;
+extern template class StandaloneT<TENNICAM_CLIENT_HISTORY_SIZE_500K>;
+
+/**
+ * @brief length of the o80 history of the standalone running with
+ * segment_id
+ */
+int read_history_size(std::string segment_id);
+
+/**
+ * @brief id of the shared memory segment in which the standalone
+ * running with segment_id writes the length of its history.
+ */
+std::string history_size_segment_id(const std::string& segment_id);
+
+/**
+ * @brief Alternative to Standalone which, instead of writing a ball
+ * in the o80 history at a fixed frequency, writes a ball only when the
+ * driver produces a new ball id (or an invalid ball when the ball is
+ * lost), i.e. the o80 iteration advances only when a new frame has
+ * been decoded and the history holds no duplicates. The history has
+ * the same layout as the one of StandaloneT<history_size> (read with
+ * the same frontends), and the same records are published next to it.
+ * The driver should be configured with ReceiveMode::POLL and without
+ * receive thread, so that Driver::get blocks until a frame arrives (or
+ * for at most the receive timeout, which bounds the time stop takes,
+ * and should therefore not be negative). Resampling is not supported
+ * (a resampled ball is produced at each call, not at each frame).
+ * The constructor throws an std::invalid_argument otherwise.
+ */
+class PublishOnChangeStandalone
+{
+public:
+    PublishOnChangeStandalone(std::shared_ptr<Driver> driver_ptr,
+                              std::string segment_id,
+                              int history_size);
+    ~PublishOnChangeStandalone();
+    /**
+     * @brief starts the driver and the thread writing the balls
+     */
+    void start();
+    /**
+     * @brief stops the thread (and then the driver)
+     */
+    void stop();
+    bool is_running() const;
+    /**
+     * @brief number of balls written in the o80 history
+     */
+    long int get_nb_published() const;
+    /**
+     * @brief loop of the thread started by start
+     */
+    void run();
+
+public:
+    // o80 backend (of any length of history)
+    class BackEnd
+    {
+    public:
+        virtual ~BackEnd();
+        virtual void pulse(const Ball& ball) = 0;
+    };
+
+private:
+    template <int QUEUE_SIZE>
+    class BackEndT;
+    void publish(const Ball& ball);
+
+private:
+    std::shared_ptr<Driver> driver_;
+    std::unique_ptr<BackEnd> backend_;
+    long int ball_id_;
+    std::atomic<long int> nb_published_;
+    std::atomic<bool> running_;
+    real_time_tools::RealTimeThread thread_;
+};
+
+/**
+ * @brief instantiates a driver (see Driver(toml_config_file,
+ * active_transform_segment_id)) and starts a PublishOnChangeStandalone
+ * over it (similar to o80's start_standalone)
+ */
+void start_publish_on_change_standalone(
+    std::string segment_id,
+    std::string toml_config_file,
+    std::string active_transform_segment_id,
+    int history_size);
+void stop_publish_on_change_standalone(std::string segment_id);
+bool is_publish_on_change_standalone_running(std::string segment_id);
+
+/**
+ * @brief o80 standalone over the MultiBallDriver: the ball of each
+ * track (see MultiBallTracker) is written in its own dof (balls of
+ * the inactive tracks being invalid, i.e. with a ball id of -1).
+ * Always uses the default length of history.
+ */
+class MultiBallStandalone
+    : public o80::Standalone<TENNICAM_CLIENT_QUEUE_SIZE,
+                             TENNICAM_CLIENT_MAX_BALLS,  // one dof per track
+                             MultiBallDriver,
+                             Ball,
+                             o80::VoidExtendedState>
+{
+public:
+    MultiBallStandalone(std::shared_ptr<MultiBallDriver> driver_ptr,
+                        double frequency,
+                        std::string segment_id);
+    o80::States<TENNICAM_CLIENT_MAX_BALLS, Ball> convert(const Balls& balls);
+    DriverIn convert(const o80::States<TENNICAM_CLIENT_MAX_BALLS, Ball>&);
+};
+
 }  // namespace tennicam_client
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "o80/front_end.hpp"
+#include "tennicam_client/ball.hpp"
+#include "tennicam_client/standalone.hpp"
+
+// number of iterations at the beginning of the o80 history not
+// used by StateQuery, as they may be overwritten by the backend while
+// the history is searched (at most a tenth of the history)
+#define TENNICAM_CLIENT_STATE_QUERY_MARGIN 1000
+
+namespace tennicam_client
+{
+/**
+ * @brief State of the ball at a given time, as computed by query_state
+ */
+class BallState
+{
+public:
+    BallState();
+    std::string to_string() const;
+
+public:
+    // id of the latest ball observed at or before time_stamp
+    long int ball_id;
+    // time (nanoseconds) the state corresponds to
+    long int time_stamp;
+    // time stamp of the ball ball_id
+    long int observation_time_stamp;
+    std::array<double, 3> position;
+    std::array<double, 3> velocity;
+    // false: interpolated between the balls observed before and after
+    // time_stamp, true: extrapolated from the latest ball observed
+    // before time_stamp
+    bool extrapolated;
+};
+
+namespace internal
+{
+// cubic Hermite interpolation between the two balls (positions
+// and velocities at their time stamps, i.e. not compensated, see
+// observed), time_stamp being between their time stamps
+void interpolate(const Ball& before,
+                 const Ball& after,
+                 long int time_stamp,
+                 BallState& state);
+// ballistic flight (gravity only) from ball (at its compensated time
+// stamp) to time_stamp
+void extrapolate(const Ball& ball,
+                 long int time_stamp,
+                 double gravity,
+                 BallState& state);
+// the ball brought back from its compensated time stamp to its time
+// stamp (gravity only, see Driver::compensate_latency)
+Ball observed(const Ball& ball, double gravity);
+}  // namespace internal
+
+/**
+ * @brief Computes the state of the ball at time_stamp (nanoseconds)
+ * from a history of balls. History is expected to have a method
+ * "Ball read(long int index)" returning the ball at index, for
+ * indexes between oldest and newest (included), the balls being
+ * ordered by time stamps (Ball::get_time_stamp). The same ball may be
+ * repeated at successive indexes (possibly with different compensated
+ * time stamps, see DriverConfig::latency_compensation, which are not
+ * ordered), and the history may contain invalid balls (ball id -1)
+ * carrying the time stamp of the latest valid ball before them (-1 if
+ * none), as written by Driver::get in an o80 history.
+ * The balls observed just before and just after time_stamp are found
+ * by binary search on the time stamps (O(log n) calls to read), and
+ * the state is interpolated between their observed states or, if no
+ * ball has been observed since time_stamp (or the ball has been lost
+ * since), extrapolated (gravity only) from the latest state of the
+ * latest ball.
+ * Returns false if no (valid) ball was observed before time_stamp.
+ */
+template <class History>
+bool query_state(History& history,
+                 long int oldest,
+                 long int newest,
+                 long int time_stamp,
+                 double gravity,
+                 BallState& state)
+{
+    // last index with a time stamp at or before time_stamp
+    long int found = -1;
+    Ball before;
+    long int low = oldest;
+    long int high = newest;
+    while (low <= high)
+    {
+        const long int middle = low + (high - low) / 2;
+        Ball ball = history.read(middle);
+        if (ball.get_time_stamp() <= time_stamp)
+        {
+            found = middle;
+            before = ball;
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    if (found < 0 || before.get_time_stamp() < 0)
+    {
+        return false;
+    }
+    if (before.get_ball_id() < 0)
+    {
+        // the ball has been lost since the valid ball with the same
+        // time stamp, which is the first of the entries with this
+        // time stamp (unless overwritten)
+        const long int lost_time_stamp = before.get_time_stamp();
+        low = oldest;
+        high = found;
+        while (low < high)
+        {
+            const long int middle = low + (high - low) / 2;
+            if (history.read(middle).get_time_stamp() < lost_time_stamp)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        before = history.read(low);
+        if (before.get_ball_id() < 0)
+        {
+            return false;
+        }
+        internal::extrapolate(before, time_stamp, gravity, state);
+        return true;
+    }
+    // the next entry, if any, has a time stamp after time_stamp,
+    // so is a valid ball (invalid balls carry earlier time stamps)
+    if (found < newest)
+    {
+        Ball after = history.read(found + 1);
+        if (after.get_ball_id() >= 0)
+        {
+            internal::interpolate(internal::observed(before, gravity),
+                                  internal::observed(after, gravity),
+                                  time_stamp,
+                                  state);
+            return true;
+        }
+    }
+    internal::extrapolate(before, time_stamp, gravity, state);
+    return true;
+}
+
+/**
+ * @brief Computes the state of the ball at any time, from the o80
+ * history written by the tennicam_client standalone running with
+ * segment_id (see query_state). Reads only O(log n) balls of the
+ * history (n being the length of the history, see read_history_size).
+ * Gravity (m/s^2, along -z) is used for extrapolation.
+ */
+class StateQuery
+{
+public:
+    StateQuery(std::string segment_id, double gravity = 9.81);
+    ~StateQuery();
+    /**
+     * @brief computes the state of the ball at time_stamp (nanoseconds,
+     * same clock as the time stamps of the balls). Returns false if
+     * no ball has been observed before time_stamp in the available
+     * history.
+     */
+    bool get(long int time_stamp, BallState& state);
+
+public:
+    // access to the o80 history (of any length)
+    class History
+    {
+    public:
+        virtual ~History();
+        virtual long int latest() = 0;
+        virtual Ball read(long int iteration) = 0;
+    };
+
+private:
+    template <int QUEUE_SIZE>
+    class FrontEndHistory;
+
+private:
+    std::unique_ptr<History> history_;
+    int history_size_;
+    double gravity_;
+};
+
+}  // namespace tennicam_client
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+namespace tennicam_client
+{
+/**
+ * @brief Running count, mean and maximum of a duration
+ * (nanoseconds)
+ */
+class TimingStatistics
+{
+public:
+    TimingStatistics();
+    void add(long int duration_ns);
+    void reset();
+    long int count() const;
+    double mean() const;
+    long int max() const;
+
+private:
+    long int count_;
+    double mean_;
+    long int max_;
+};
+
+/**
+ * @brief Durations (nanoseconds) of the processing stages
+ * of a tennicam frame by the Driver (-1 for the stages that have
+ * not been performed, e.g. decode and process when no frame
+ * has been received)
+ */
+class StageTimings
+{
+public:
+    StageTimings();
+
+public:
+    // waiting for / reading the message from zmq
+    long int receive_ns;
+    // parsing of the message
+    long int decode_ns;
+    // transform and velocity estimation
+    long int process_ns;
+};
+
+/**
+ * @brief Statistics on the durations of the processing stages
+ * of the Driver. When the driver uses a receive thread, hand_off
+ * is the duration between the moment a ball has been pushed into the
+ * queue by the receive thread and the moment it has been popped by
+ * Driver::get.
+ */
+class DriverTimings
+{
+public:
+    void add(const StageTimings& stage_timings);
+    void reset();
+    std::string to_string() const;
+
+public:
+    TimingStatistics receive;
+    TimingStatistics decode;
+    TimingStatistics process;
+    TimingStatistics hand_off;
+};
+
+}  // namespace tennicam_client
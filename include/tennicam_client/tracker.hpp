@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include "tennicam_client/ball.hpp"
+#include "tennicam_client/driver_config.hpp"
+#include "tennicam_client/estimator.hpp"
+#include "tennicam_client/frame.hpp"
+
+// maximal number of balls tracked simultaneously, i.e. number
+// of dofs of the MultiBallStandalone
+#define TENNICAM_CLIENT_MAX_BALLS 10
+
+namespace tennicam_client
+{
+/**
+ * @brief One ball per track (see MultiBallTracker). Balls of
+ * inactive tracks are invalid (ball_id -1).
+ */
+typedef std::array<Ball, TENNICAM_CLIENT_MAX_BALLS> Balls;
+
+/**
+ * @brief Associates the balls detected at each frame to persistent
+ * tracks (one per ball in view), each track having its own velocity
+ * estimator (see DriverConfig::estimator).
+ * At each frame, the position of each track is predicted (current
+ * velocity and gravity), and the detections are assigned to the tracks
+ * so that the sum of the squared distances between detections and
+ * predictions is minimal (Hungarian algorithm), pairs further apart
+ * than max_distance not being associated. Unassigned detections start
+ * new tracks (if a slot is available), and tracks not associated to any
+ * detection for more than max_missed frames are closed.
+ * Tracks keep their slot (index in Balls) for their whole lifetime.
+ * The ball id of a slot increases with each new observation (as for
+ * Driver), and the segment id of the balls (see Ball::get_segment_id)
+ * identifies the track (SEGMENT_START being set for the first ball of
+ * a track). Does not allocate memory after construction, and the cost
+ * per frame is O(n^3) for n detections / tracks (n at most
+ * TENNICAM_CLIENT_MAX_DETECTIONS).
+ */
+class MultiBallTracker
+{
+public:
+    MultiBallTracker(const DriverConfig& config);
+    /**
+     * @brief closes all tracks
+     */
+    void reset();
+    /**
+     * @brief updates the tracks with the positions (transformed)
+     * of the balls detected at time_stamp (nanoseconds). Ignored if
+     * time_stamp is not more recent than the previous one.
+     */
+    void update(long int time_stamp,
+                const std::array<double, 3>* positions,
+                std::size_t nb_positions);
+    /**
+     * @brief no ball detected at this frame
+     */
+    void miss();
+    const Balls& get_balls() const;
+    /**
+     * @brief number of active tracks
+     */
+    std::size_t get_nb_tracks() const;
+
+private:
+    class Track
+    {
+    public:
+        bool active;
+        // segment id of the balls of the track
+        long int track_id;
+        long int time_stamp;
+        std::array<double, 3> position;
+        std::array<double, 3> velocity;
+        int nb_missed;
+        std::unique_ptr<Estimator> estimator;
+    };
+    void close(std::size_t slot);
+    void observe(std::size_t slot,
+                 long int time_stamp,
+                 const std::array<double, 3>& position,
+                 int events);
+
+private:
+    double max_distance_;
+    int max_missed_;
+    double gravity_;
+    long int time_stamp_;
+    long int nb_started_tracks_;
+    std::array<Track, TENNICAM_CLIENT_MAX_BALLS> tracks_;
+    std::array<long int, TENNICAM_CLIENT_MAX_BALLS> ball_ids_;
+    Balls balls_;
+};
+
+namespace internal
+{
+// up to TENNICAM_CLIENT_MAX_DETECTIONS tracks / detections
+constexpr std::size_t MAX_ASSOCIATION =
+    TENNICAM_CLIENT_MAX_BALLS > TENNICAM_CLIENT_MAX_DETECTIONS
+        ? TENNICAM_CLIENT_MAX_BALLS
+        : TENNICAM_CLIENT_MAX_DETECTIONS;
+typedef std::array<std::array<double, MAX_ASSOCIATION>, MAX_ASSOCIATION>
+    CostMatrix;
+/**
+ * @brief minimal cost assignment (Hungarian algorithm) for the square
+ * cost matrix of size n: row i is assigned to column assignment[i].
+ */
+void assign(const CostMatrix& cost,
+            std::size_t n,
+            std::array<std::size_t, MAX_ASSOCIATION>& assignment);
+}  // namespace internal
+
+}  // namespace tennicam_client
@@ -1,14 +1,27 @@
 #pragma once
 
-#include <armadillo>  // vec
 #include <array>
-#include "shared_memory/serializer.hpp"
-#include "shared_memory/shared_memory.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include "tennicam_client/seqlock.hpp"
+#include "tennicam_client/shared_record.hpp"
+
+// minimal number of points processed by each thread by the batch
+// versions of Transform::apply
+#define TENNICAM_CLIENT_TRANSFORM_POINTS_PER_THREAD 65536
 
 namespace tennicam_client
 {
+// row major 3x3 matrix
+typedef std::array<std::array<double, 3>, 3> Matrix3;
+
 /**
- * @brief represents a 3d transform (translation and rotation)
+ * @brief represents a 3d transform (translation and rotation).
+ * Instances are immutable and do not allocate memory, so apply
+ * may be called concurrently from several threads.
  */
 class Transform
 {
@@ -19,19 +32,117 @@ public:
      */
     Transform(std::array<double, 3> translation,
               std::array<double, 3> rotation);
+    /**
+     * @param rotation_matrix rotation applied first
+     * @param translation (x, y, z)-translation applied after rotation.
+     */
+    constexpr Transform(const Matrix3& rotation_matrix,
+                        const std::array<double, 3>& translation)
+        : rotation_{rotation_matrix}, translation_{translation}
+    {
+    }
     /**
      * Apply the transform
      */
-    std::array<double, 3> apply(const std::array<double, 3>& v) const;
+    constexpr std::array<double, 3> apply(const std::array<double, 3>& v) const
+    {
+        std::array<double, 3> transformed{};
+        for (std::size_t row = 0; row < 3; row++)
+        {
+            transformed[row] = rotation_[row][0] * v[0] +
+                               rotation_[row][1] * v[1] +
+                               rotation_[row][2] * v[2] + translation_[row];
+        }
+        return transformed;
+    }
+    /**
+     * Apply the transform to nb_points positions stored as a row major
+     * (nb_points, 3) array (e.g. a C contiguous numpy array).
+     * transformed may be the same array as points (in place transform),
+     * but the arrays should not otherwise overlap.
+     * @param nb_threads number of threads the points are split over.
+     * If 0, uses as many threads as the hardware supports, but with
+     * at least TENNICAM_CLIENT_TRANSFORM_POINTS_PER_THREAD points
+     * per thread.
+     */
+    void apply(const double* points,
+               double* transformed,
+               std::size_t nb_points,
+               unsigned int nb_threads = 0) const;
+    /**
+     * Apply the transform to nb_points positions stored as a structure
+     * of arrays (one array per coordinate). This layout allows the
+     * compiler to vectorize the computation, and should be preferred
+     * for large point sets when the data is available in this form.
+     * The output arrays should not overlap the input arrays.
+     * @param nb_threads: see the other batch apply method.
+     */
+    void apply(const double* x,
+               const double* y,
+               const double* z,
+               double* transformed_x,
+               double* transformed_y,
+               double* transformed_z,
+               std::size_t nb_points,
+               unsigned int nb_threads = 0) const;
+    constexpr const Matrix3& get_rotation_matrix() const
+    {
+        return rotation_;
+    }
+    constexpr const std::array<double, 3>& get_translation() const
+    {
+        return translation_;
+    }
+
+private:
+    Matrix3 rotation_;
+    std::array<double, 3> translation_;
+};
+
+namespace internal
+{
+// translation and rotation (Euler angles) of a transform, which may
+// be written / read concurrently (possibly by different processes, see
+// SharedRecord and Seqlock)
+class TransformRecord
+{
+public:
+    // increases the version by 2
+    void write(const std::array<double, 3>& translation,
+               const std::array<double, 3>& rotation);
+    // returns the version of the values read
+    std::uint64_t read(std::array<double, 3>& translation,
+                       std::array<double, 3>& rotation) const;
+    // odd while a write is ongoing
+    std::uint64_t get_version() const
+    {
+        return values_.get_version();
+    }
 
 private:
-    arma::vec translation_;
-    arma::mat rotation_;
-    mutable arma::vec tmp_;
+    Seqlock<std::array<double, 6>> values_;
 };
 
+}  // namespace internal
+
+/**
+ * @brief id of the shared memory segment in which the transform
+ * associated to the segment_id is written.
+ */
+std::string transform_segment_id(const std::string& segment_id);
+
+/**
+ * @brief returns the (translation, rotation) written in the shared
+ * memory. Throws boost::interprocess::interprocess_exception if
+ * it has not been written yet.
+ */
 std::tuple<std::array<double, 3>, std::array<double, 3>>
 read_transform_from_memory(std::string segment_id);
+/**
+ * @brief writes the transform in the shared memory. A driver in "active
+ * transform mode" with the same segment id will use it from its next
+ * iteration.
+ */
 void write_transform_to_memory(std::string segment_id,
                                const std::array<double, 3>& translation,
                                const std::array<double, 3>& rotation);
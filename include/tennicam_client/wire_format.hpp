@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "tennicam_client/frame.hpp"
+
+namespace tennicam_client
+{
+/**
+ * Encoding of the messages sent over zmq: json formatted strings
+ * (as sent by tennicam) or binary frames (see BinaryFrameHeader).
+ */
+enum class WireFormat
+{
+    JSON,
+    BINARY
+};
+
+/**
+ * returns the wire format corresponding to the string ("json" or "binary"),
+ * throws an std::invalid_argument exception for any other value.
+ */
+WireFormat to_wire_format(const std::string& wire_format);
+
+/**
+ * @brief Header of a binary frame. A binary frame is this header followed
+ * by nb_detections times 3 doubles (x, y, z of each detected ball),
+ * all in host byte order (i.e. little endian on the supported platforms).
+ * The first byte of a binary frame is 0, which can not be the first
+ * byte of a json message, so that both formats can be used on the same
+ * channel (see is_binary_frame).
+ */
+struct BinaryFrameHeader
+{
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t nb_detections;
+    std::int64_t num;
+    std::int64_t time_stamp;
+    double proc_time;
+};
+
+static_assert(sizeof(BinaryFrameHeader) == 32,
+              "unexpected padding in BinaryFrameHeader");
+
+// bytes: 0x00 'T' 'C' 'B' (little endian)
+constexpr std::uint32_t BINARY_FRAME_MAGIC = 0x42435400;
+constexpr std::uint16_t BINARY_FRAME_VERSION = 1;
+
+/**
+ * returns the number of bytes of a binary frame with the given number
+ * of detections
+ */
+constexpr std::size_t binary_frame_size(std::size_t nb_detections)
+{
+    return sizeof(BinaryFrameHeader) + nb_detections * 3 * sizeof(double);
+}
+
+/**
+ * returns true if the message starts with the magic number
+ * of binary frames
+ */
+bool is_binary_frame(const char* data, std::size_t size);
+
+/**
+ * writes the binary encoding of the frame in buffer, which is expected
+ * to be of (at least) binary_frame_size(frame.nb_detections) bytes.
+ * If the frame is marked as detected but nb_detections is 0, position
+ * is encoded as the single detection. Returns the number of bytes
+ * written.
+ */
+std::size_t encode_binary_frame(const Frame& frame, char* buffer);
+
+/**
+ * decodes the binary frame, returns false if the message is not a valid
+ * binary frame (wrong magic number or version, truncated message).
+ * Detections above TENNICAM_CLIENT_MAX_DETECTIONS are ignored.
+ */
+bool decode_binary_frame(const char* data, std::size_t size, Frame& frame);
+
+}  // namespace tennicam_client
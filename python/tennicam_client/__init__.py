@@ -1,2 +1,3 @@
 from tennicam_client_wrp import *
 from .parser import parse, get_default_config_file
+from .standalone import start_standalone, stop_standalone, get_frontend
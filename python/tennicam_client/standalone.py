@@ -0,0 +1,91 @@
+import typing
+import tennicam_client_wrp
+
+# length of the o80 history -> prefix of the corresponding standalone
+# functions and frontend class (see srcpy/wrappers.cpp)
+_PREFIXES = {
+    1000: ("history_1k_", "History1k"),
+    10000: ("history_10k_", "History10k"),
+    50000: ("", ""),
+    500000: ("history_500k_", "History500k"),
+}
+
+# segment_id -> (length of the history, publish on change) of the
+# standalones started by this process
+_started: typing.Dict[str, typing.Tuple[int, bool]] = {}
+
+
+def _prefixes(history_size: int) -> typing.Tuple[str, str]:
+    try:
+        return _PREFIXES[history_size]
+    except KeyError:
+        raise ValueError(
+            "unsupported history size: {} (expected one of {})".format(
+                history_size, ", ".join(str(s) for s in _PREFIXES)
+            )
+        )
+
+
+def start_standalone(
+    segment_id: str,
+    frequency: float,
+    bursting: bool,
+    config_path: str,
+    active_transform_segment_id: str,
+    history_size: typing.Optional[int] = None,
+    publish_on_change: typing.Optional[bool] = None,
+) -> None:
+    """
+    Starts the o80 standalone, with a history of history_size iterations
+    (1000, 10000, 50000 or 500000). If publish_on_change is true, a ball
+    is written in the history only when a new ball is observed (frequency
+    and bursting are then not used), else at each iteration. If None, the
+    values of the [driver] section of the configuration file are used.
+    """
+
+    if history_size is None:
+        history_size = tennicam_client_wrp.parse_history_size(str(config_path))
+    if publish_on_change is None:
+        publish_on_change = tennicam_client_wrp.parse_publish_on_change(
+            str(config_path)
+        )
+    prefix, _ = _prefixes(history_size)
+    if publish_on_change:
+        tennicam_client_wrp.start_publish_on_change_standalone(
+            segment_id,
+            str(config_path),
+            active_transform_segment_id,
+            history_size,
+        )
+    else:
+        getattr(tennicam_client_wrp, prefix + "start_standalone")(
+            segment_id,
+            frequency,
+            bursting,
+            str(config_path),
+            active_transform_segment_id,
+        )
+    _started[segment_id] = (history_size, publish_on_change)
+
+
+def stop_standalone(segment_id: str) -> None:
+    """
+    Stops the standalone started with start_standalone.
+    """
+
+    history_size, publish_on_change = _started.pop(segment_id, (50000, False))
+    if publish_on_change:
+        tennicam_client_wrp.stop_publish_on_change_standalone(segment_id)
+        return
+    prefix, _ = _prefixes(history_size)
+    getattr(tennicam_client_wrp, prefix + "stop_standalone")(segment_id)
+
+
+def get_frontend(segment_id: str):
+    """
+    Returns a frontend to the standalone running with segment_id,
+    whatever the length of its history.
+    """
+
+    _, prefix = _prefixes(tennicam_client_wrp.read_history_size(segment_id))
+    return getattr(tennicam_client_wrp, prefix + "FrontEnd")(segment_id)
@@ -2,7 +2,13 @@
 
 namespace tennicam_client
 {
-Ball::Ball() : ball_id_{-1}
+Ball::Ball()
+    : ball_id_{-1},
+      time_stamp_ns_{-1},
+      compensated_time_stamp_ns_{-1},
+      nb_skipped_frames_{0},
+      segment_id_{-1},
+      events_{0}
 {
 }
 
@@ -13,10 +19,47 @@ Ball::Ball(long int ball_id,
     : ball_id_{ball_id},
       position_{position},
       velocity_{velocity},
-      time_stamp_ns_{time_stamp_ns}
+      time_stamp_ns_{time_stamp_ns},
+      compensated_time_stamp_ns_{time_stamp_ns},
+      nb_skipped_frames_{0},
+      segment_id_{-1},
+      events_{0}
 {
 }
 
+Ball::Ball(const BallRecord& record)
+{
+    ball_id_ = record.ball_id;
+    time_stamp_ns_ = record.time_stamp;
+    compensated_time_stamp_ns_ = record.compensated_time_stamp;
+    nb_skipped_frames_ = record.nb_skipped_frames;
+    segment_id_ = record.segment_id;
+    for (std::size_t dim = 0; dim < 3; dim++)
+    {
+        position_[dim] = record.position[dim];
+        velocity_[dim] = record.velocity[dim];
+    }
+    events_ = record.events;
+}
+
+BallRecord Ball::to_record() const
+{
+    BallRecord record;
+    record.ball_id = ball_id_;
+    record.time_stamp = time_stamp_ns_;
+    record.compensated_time_stamp = compensated_time_stamp_ns_;
+    record.nb_skipped_frames = nb_skipped_frames_;
+    record.segment_id = segment_id_;
+    for (std::size_t dim = 0; dim < 3; dim++)
+    {
+        record.position[dim] = position_[dim];
+        record.velocity[dim] = velocity_[dim];
+    }
+    record.events = events_;
+    record.reserved = 0;
+    return record;
+}
+
 void Ball::set_position(double x, double y, double z)
 {
     position_[0] = x;
@@ -58,15 +101,62 @@ long int Ball::get_time_stamp() const
     return time_stamp_ns_;
 }
 
+void Ball::set_time_stamp(long int time_stamp_ns)
+{
+    time_stamp_ns_ = time_stamp_ns;
+    compensated_time_stamp_ns_ = time_stamp_ns;
+}
+
+long int Ball::get_compensated_time_stamp() const
+{
+    return compensated_time_stamp_ns_;
+}
+
+void Ball::set_compensated_time_stamp(long int time_stamp_ns)
+{
+    compensated_time_stamp_ns_ = time_stamp_ns;
+}
+
 long int Ball::get_ball_id() const
 {
     return ball_id_;
 }
 
+long int Ball::get_nb_skipped_frames() const
+{
+    return nb_skipped_frames_;
+}
+
+void Ball::set_nb_skipped_frames(long int nb_skipped_frames)
+{
+    nb_skipped_frames_ = nb_skipped_frames;
+}
+
+long int Ball::get_segment_id() const
+{
+    return segment_id_;
+}
+
+int Ball::get_events() const
+{
+    return events_;
+}
+
+void Ball::set_segment(long int segment_id, int events)
+{
+    segment_id_ = segment_id;
+    events_ = events;
+}
+
 std::string Ball::to_string() const
 {
     std::stringstream s;
     s << "Ball " << ball_id_ << "(" << time_stamp_ns_ << ") ";
+    if (compensated_time_stamp_ns_ != time_stamp_ns_)
+    {
+        s << "(compensated: +"
+          << (compensated_time_stamp_ns_ - time_stamp_ns_) / 1000 << "us) ";
+    }
     s << "position: ";
     for (const double& p : position_)
     {
@@ -77,6 +167,22 @@ std::string Ball::to_string() const
     {
         s << std::setprecision(3) << v << " ";
     }
+    if (segment_id_ >= 0)
+    {
+        s << "segment: " << segment_id_ << " ";
+        if (events_ & BOUNCE)
+        {
+            s << "(bounce) ";
+        }
+        if (events_ & HIT)
+        {
+            s << "(hit) ";
+        }
+    }
+    if (events_ & OUTLIER)
+    {
+        s << "(outlier) ";
+    }
     s << std::endl;
     return s.str();
 }
@@ -0,0 +1,100 @@
+#include <iostream>
+#include "tennicam_client/dummy_server.hpp"
+
+// Measures, for various publishing rates of DummyServer, how many
+// of the published balls are returned by a Driver for which get()
+// is called at the (default) frequency of the standalone (200Hz),
+// depending on the ingestion policy.
+
+static void benchmark(const tennicam_client::DriverConfig& config,
+                      const std::string& label,
+                      double server_frequency,
+                      double duration)
+{
+    const double frequency = 200.;
+
+    tennicam_client::Driver driver(config);
+    driver.start();
+
+    long int nb_balls = 0;
+    long int previous_ball_id = -1;
+    long int max_batch_size = 0;
+    double get_duration = 0;
+    long int nb_iterations = 0;
+
+    auto period =
+        std::chrono::nanoseconds(static_cast<long int>(1e9 / frequency));
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::duration<double>(duration));
+    auto next = start;
+
+    while (std::chrono::steady_clock::now() < end)
+    {
+        auto get_start = std::chrono::steady_clock::now();
+        tennicam_client::Ball ball = driver.get();
+        get_duration += std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - get_start)
+                            .count();
+        nb_iterations++;
+        long int batch_size = static_cast<long int>(driver.get_batch().size());
+        if (batch_size > 0)
+        {
+            nb_balls += batch_size;
+            max_batch_size = std::max(max_batch_size, batch_size);
+        }
+        else if (ball.get_ball_id() >= 0 &&
+                 ball.get_ball_id() != previous_ball_id)
+        {
+            nb_balls++;
+        }
+        previous_ball_id = ball.get_ball_id();
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+
+    double wall = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    driver.stop();
+
+    std::cout << label << " | published: " << server_frequency
+              << " balls/s | returned: " << std::setprecision(5)
+              << nb_balls / wall << " balls/s | max batch size "
+              << max_batch_size << " | get(): " << std::setprecision(3)
+              << 1e6 * get_duration / nb_iterations << "us (mean)"
+              << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    double duration = argc > 1 ? std::atof(argv[1]) : 5.;
+
+    std::array<double, 3> zeros;
+    zeros.fill(0);
+    int port = 7663;
+
+    std::cout << std::endl;
+
+    for (double server_frequency : {1000., 2000., 5000.})
+    {
+        tennicam_client::DriverConfig config(
+            "127.0.0.1", port++, zeros, zeros);
+        tennicam_client::DummyServer server{
+            config, tennicam_client::WireFormat::JSON, server_frequency};
+        server.start();
+
+        config.ingestion_policy = tennicam_client::IngestionPolicy::SINGLE;
+        benchmark(config, "single", server_frequency, duration);
+
+        config.ingestion_policy = tennicam_client::IngestionPolicy::ALL;
+        benchmark(config, "all", server_frequency, duration);
+
+        config.io_thread = true;
+        benchmark(config, "all (receive thread)", server_frequency, duration);
+
+        server.stop();
+    }
+
+    std::cout << std::endl;
+}
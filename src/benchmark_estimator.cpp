@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "tennicam_client/estimator.hpp"
+
+// Measures the cost per update of the velocity estimators, and their
+// error on simulated (noisy) ballistic trajectories
+
+class Observation
+{
+public:
+    long int time_stamp;
+    std::array<double, 3> position;
+    std::array<double, 3> velocity;
+};
+
+// successive throws of 1 second, observed at 180Hz (with timing jitter)
+static std::vector<Observation> create_observations(std::size_t nb_obs,
+                                                    double noise)
+{
+    std::mt19937 generator(0);
+    std::normal_distribution<double> position_noise(0., noise);
+    std::uniform_int_distribution<long int> jitter(-300000, 300000);
+    constexpr long int period_ns = 5555556;
+    constexpr double g = 9.81;
+    std::vector<Observation> observations(nb_obs);
+    for (std::size_t index = 0; index < nb_obs; index++)
+    {
+        long int time_stamp = static_cast<long int>(index) * period_ns;
+        double t = static_cast<double>(index % 180) * period_ns * 1e-9;
+        Observation& obs = observations[index];
+        obs.time_stamp = time_stamp + jitter(generator);
+        double jittered_t = t + (obs.time_stamp - time_stamp) * 1e-9;
+        obs.velocity = {1., -4., 3. - g * jittered_t};
+        std::array<double, 3> position = {
+            jittered_t, 3. - 4. * jittered_t,
+            1. + 3. * jittered_t - 0.5 * g * jittered_t * jittered_t};
+        for (std::size_t dim = 0; dim < 3; dim++)
+        {
+            obs.position[dim] = position[dim] + position_noise(generator);
+        }
+    }
+    return observations;
+}
+
+static void benchmark(const std::string& label,
+                      tennicam_client::Estimator& estimator,
+                      const std::vector<Observation>& observations)
+{
+    double squared_error = 0;
+    std::size_t nb_errors = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < observations.size(); index++)
+    {
+        const Observation& obs = observations[index];
+        // new throw
+        if (index % 180 == 0)
+        {
+            estimator.reset();
+        }
+        std::array<double, 3> v =
+            estimator.update(obs.time_stamp, obs.position);
+        // ignoring the first observations of each throw
+        if (index % 180 >= 20)
+        {
+            for (std::size_t dim = 0; dim < 3; dim++)
+            {
+                squared_error += (v[dim] - obs.velocity[dim]) *
+                                 (v[dim] - obs.velocity[dim]);
+            }
+            nb_errors++;
+        }
+    }
+    double duration = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    std::cout << label << ": " << 1e9 * duration / observations.size()
+              << " ns per update | velocity rms error: "
+              << std::sqrt(squared_error / nb_errors) << " m/s" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t nb_obs =
+        argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 1000000;
+    constexpr double noise = 0.003;
+    std::vector<Observation> observations =
+        create_observations(nb_obs, noise);
+
+    std::cout << "\n" << nb_obs << " updates, position noise: " << noise
+              << " m\n"
+              << std::endl;
+    tennicam_client::FiniteDifference finite_difference;
+    benchmark("finite difference", finite_difference, observations);
+    tennicam_client::DriverConfig config;
+    tennicam_client::KalmanFilter kalman(
+        noise, config.kalman_process_noise, config.gravity);
+    benchmark("kalman filter", kalman, observations);
+    for (int window : {5, 10, 20, 60})
+    {
+        tennicam_client::PolynomialFit polynomial(window, 2);
+        benchmark(std::string("polynomial fit (window ") +
+                      std::to_string(window) + std::string(")"),
+                  polynomial,
+                  observations);
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "json_helper/json_helper.hpp"
+#include "tennicam_client/frame_parser.hpp"
+
+// Compares the cost of parsing tennicam messages using parse_json_frame
+// and using the generic json parser (as done by Driver before
+// parse_json_frame was introduced)
+
+static std::vector<std::string> create_messages(std::size_t nb_messages)
+{
+    // same format as DummyServer::perform
+    std::vector<std::string> messages;
+    for (std::size_t num = 0; num < nb_messages; num++)
+    {
+        json jframe;
+        if (num % 10 == 0)
+        {
+            jframe = json{{"num", num},
+                          {"time", 1654012345678901234 + num * 5000000},
+                          {"proc_time", 1},
+                          {"obs", nullptr}};
+        }
+        else
+        {
+            json obs;
+            obs.push_back(cos(0.001 * num));
+            obs.push_back(sin(0.001 * num));
+            obs.push_back(-0.0005 * num);
+            jframe = json{{"num", num},
+                          {"time", 1654012345678901234 + num * 5000000},
+                          {"proc_time", 1},
+                          {"obs", obs}};
+        }
+        messages.push_back(jframe.dump());
+    }
+    return messages;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t nb_messages =
+        argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 1000000;
+    std::vector<std::string> messages = create_messages(nb_messages);
+
+    double checksum = 0;
+
+    // generic json parsing
+    json_helper::Jsonhelper jh;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& message : messages)
+    {
+        std::string rpl = std::string(message.data(), message.size());
+        jh.j = json::parse(rpl);
+        if (jh.j["obs"].is_null())
+        {
+            continue;
+        }
+        checksum += static_cast<double>(static_cast<long int>(jh.j["time"]));
+        for (std::size_t index = 0; index < 3; index++)
+        {
+            checksum += static_cast<double>(jh.j["obs"][index]);
+        }
+    }
+    double generic = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+    // parse_json_frame
+    tennicam_client::Frame frame;
+    start = std::chrono::steady_clock::now();
+    for (const std::string& message : messages)
+    {
+        if (!tennicam_client::parse_json_frame(
+                message.data(), message.size(), frame))
+        {
+            std::cout << "failed to parse: " << message << std::endl;
+            return 1;
+        }
+        if (!frame.detected)
+        {
+            continue;
+        }
+        checksum -= static_cast<double>(frame.time_stamp);
+        for (std::size_t index = 0; index < 3; index++)
+        {
+            checksum -= frame.position[index];
+        }
+    }
+    double specialized = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+    std::cout << "\n"
+              << nb_messages << " messages, e.g. " << messages[1] << "\n\n"
+              << "generic json parser: " << 1e9 * generic / nb_messages
+              << " ns per message\n"
+              << "parse_json_frame:    " << 1e9 * specialized / nb_messages
+              << " ns per message\n"
+              << "(checksum: " << checksum << ")\n"
+              << std::endl;
+}
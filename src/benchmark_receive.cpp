@@ -0,0 +1,122 @@
+#include <time.h>
+#include <iostream>
+#include "tennicam_client/dummy_server.hpp"
+
+// Compares the CPU usage and the latency of Driver::get()
+// for the different receive modes and wire formats, using balls
+// published by an instance of DummyServer (i.e. at 100Hz)
+
+static double thread_cpu_time()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+static void benchmark(const tennicam_client::DriverConfig& config,
+                      const std::string& label,
+                      double frequency,
+                      double duration)
+{
+    tennicam_client::Driver driver(config);
+    driver.start();
+
+    long int nb_iterations = 0;
+    long int nb_balls = 0;
+    long int previous_ball_id = -1;
+    double latency_sum = 0;
+    double latency_max = 0;
+
+    auto period = std::chrono::nanoseconds(
+        static_cast<long int>(frequency > 0 ? 1e9 / frequency : 0));
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::duration<double>(duration));
+    auto next = start;
+    double cpu_start = thread_cpu_time();
+
+    while (std::chrono::steady_clock::now() < end)
+    {
+        tennicam_client::Ball ball = driver.get();
+        nb_iterations++;
+        if (ball.get_ball_id() >= 0 && ball.get_ball_id() != previous_ball_id)
+        {
+            // DummyServer time stamps balls with o80::time_now
+            double latency = static_cast<double>(o80::time_now().count() -
+                                                 ball.get_time_stamp()) *
+                             1e-3;
+            latency_sum += latency;
+            latency_max = std::max(latency_max, latency);
+            nb_balls++;
+            previous_ball_id = ball.get_ball_id();
+        }
+        if (frequency > 0)
+        {
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    double cpu = thread_cpu_time() - cpu_start;
+    double wall = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+
+    driver.stop();
+
+    std::cout << label << ": " << nb_iterations << " iterations, " << nb_balls
+              << " new balls, " << driver.get_nb_stalls() << " stalls | cpu "
+              << std::setprecision(3) << 100.0 * cpu / wall << "% | latency "
+              << (nb_balls > 0 ? latency_sum / nb_balls : 0.) << "us (mean) "
+              << latency_max << "us (max)\n\t"
+              << driver.get_timings().to_string() << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    // frequency of the calls to Driver::get (0: as fast as possible,
+    // as for a standalone in bursting mode)
+    double frequency = argc > 1 ? std::atof(argv[1]) : 200.;
+    double duration = argc > 2 ? std::atof(argv[2]) : 5.;
+
+    std::cout << "\ncalling Driver::get at " << frequency << "Hz for "
+              << duration << " seconds\n"
+              << std::endl;
+
+    std::array<double, 3> zeros;
+    zeros.fill(0);
+    int port = 7661;
+
+    for (tennicam_client::WireFormat wire_format :
+         {tennicam_client::WireFormat::JSON,
+          tennicam_client::WireFormat::BINARY})
+    {
+        std::string format =
+            wire_format == tennicam_client::WireFormat::JSON ? "json"
+                                                              : "binary";
+        tennicam_client::DriverConfig config(
+            "127.0.0.1", port++, zeros, zeros);
+
+        tennicam_client::DummyServer server{config, wire_format};
+        server.start();
+
+        config.receive_mode = tennicam_client::ReceiveMode::SPIN;
+        benchmark(config, format + " | spin", frequency, duration);
+
+        config.receive_mode = tennicam_client::ReceiveMode::POLL;
+        config.receive_spin_us = 0;
+        benchmark(config, format + " | poll", frequency, duration);
+
+        config.receive_spin_us = 200;
+        benchmark(config, format + " | poll (200us spin)", frequency, duration);
+
+        config.io_thread = true;
+        benchmark(config, format + " | receive thread", frequency, duration);
+        config.io_thread = false;
+
+        server.stop();
+    }
+
+    std::cout << std::endl;
+}
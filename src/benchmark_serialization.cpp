@@ -0,0 +1,145 @@
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "shared_memory/serializer.hpp"
+#include "tennicam_client/ball.hpp"
+
+// Measures the cost of writing / reading a ball to / from memory (as
+// performed by o80 at each iteration), for the cereal serialization
+// of Ball (single block, see Ball::serialize), the previous field by
+// field cereal serialization, and a memcpy of BallRecord
+
+// same attributes as Ball, serialized field by field (previous
+// implementation of Ball::serialize)
+class FieldBall
+{
+public:
+    FieldBall()
+    {
+    }
+    FieldBall(const tennicam_client::Ball& ball)
+        : ball_id(ball.get_ball_id()),
+          position(ball.get_position()),
+          velocity(ball.get_velocity()),
+          time_stamp_ns(ball.get_time_stamp()),
+          compensated_time_stamp_ns(ball.get_compensated_time_stamp()),
+          nb_skipped_frames(ball.get_nb_skipped_frames()),
+          segment_id(ball.get_segment_id()),
+          events(ball.get_events())
+    {
+    }
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(position,
+                velocity,
+                ball_id,
+                time_stamp_ns,
+                compensated_time_stamp_ns,
+                nb_skipped_frames,
+                segment_id,
+                events);
+    }
+
+public:
+    long int ball_id;
+    std::array<double, 3> position;
+    std::array<double, 3> velocity;
+    long int time_stamp_ns;
+    long int compensated_time_stamp_ns;
+    long int nb_skipped_frames;
+    long int segment_id;
+    int events;
+};
+
+template <class T>
+static void benchmark_cereal(const std::string& label,
+                             const std::vector<tennicam_client::Ball>& balls)
+{
+    std::vector<T> in(balls.begin(), balls.end());
+    std::vector<T> out(balls.size());
+    shared_memory::Serializer<T> serializer;
+    std::vector<std::string> buffer(balls.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < balls.size(); index++)
+    {
+        buffer[index] = serializer.serialize(in[index]);
+    }
+    double write = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    start = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < balls.size(); index++)
+    {
+        serializer.deserialize(buffer[index], out[index]);
+    }
+    double read = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+
+    std::cout << label << " (" << buffer[0].size() << " bytes): write "
+              << 1e9 * write / balls.size() << " ns | read "
+              << 1e9 * read / balls.size() << " ns" << std::endl;
+}
+
+template <class Record>
+static void benchmark_memcpy(const std::string& label,
+                             const std::vector<tennicam_client::Ball>& balls,
+                             Record (tennicam_client::Ball::*to_record)()
+                                 const)
+{
+    std::vector<char> buffer(balls.size() * sizeof(Record));
+    std::vector<tennicam_client::Ball> out(balls.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < balls.size(); index++)
+    {
+        Record record = (balls[index].*to_record)();
+        std::memcpy(&buffer[index * sizeof(Record)], &record, sizeof(Record));
+    }
+    double write = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    start = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < balls.size(); index++)
+    {
+        Record record;
+        std::memcpy(&record, &buffer[index * sizeof(Record)], sizeof(Record));
+        out[index] = tennicam_client::Ball(record);
+    }
+    double read = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+
+    std::cout << label << " (" << sizeof(Record) << " bytes): write "
+              << 1e9 * write / balls.size() << " ns | read "
+              << 1e9 * read / balls.size()
+              << " ns (checksum: " << out.back().get_position()[0] << ")"
+              << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t nb_balls =
+        argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 1000000;
+    std::vector<tennicam_client::Ball> balls(nb_balls);
+    for (std::size_t index = 0; index < nb_balls; index++)
+    {
+        double d = static_cast<double>(index);
+        balls[index] = tennicam_client::Ball(
+            static_cast<long int>(index),
+            {cos(d * 0.001), sin(d * 0.001), d * 1e-6},
+            {1., -2., 3.},
+            static_cast<long int>(index) * 1000000);
+    }
+
+    std::cout << "\nper ball cost (" << nb_balls << " balls)\n" << std::endl;
+    benchmark_cereal<tennicam_client::Ball>("cereal, single block", balls);
+    benchmark_cereal<FieldBall>("cereal, field by field (previous)", balls);
+    benchmark_memcpy<tennicam_client::BallRecord>(
+        "memcpy BallRecord", balls, &tennicam_client::Ball::to_record);
+    std::cout << std::endl;
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "tennicam_client/tracker.hpp"
+
+// Measures the cost per frame of the association of the detected balls
+// to the tracks (MultiBallTracker), for an increasing number of balls
+// in view (plus spurious detections)
+
+typedef std::array<std::array<double, 3>, TENNICAM_CLIENT_MAX_DETECTIONS>
+    Detections;
+
+// nb_balls balls thrown in random directions, observed at 180Hz
+// (in random order), plus nb_spurious random detections
+static std::vector<Detections> create_frames(std::size_t nb_frames,
+                                             std::size_t nb_balls,
+                                             std::size_t nb_spurious)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> uniform(-3., 3.);
+    constexpr double dt = 1. / 180.;
+    constexpr double g = 9.81;
+    std::vector<std::array<double, 3>> starts(nb_balls);
+    std::vector<std::array<double, 3>> velocities(nb_balls);
+    for (std::size_t ball = 0; ball < nb_balls; ball++)
+    {
+        starts[ball] = {uniform(generator), uniform(generator), 1.};
+        velocities[ball] = {
+            uniform(generator), uniform(generator), 3. + uniform(generator)};
+    }
+    std::vector<Detections> frames(nb_frames);
+    for (std::size_t index = 0; index < nb_frames; index++)
+    {
+        // throws of 1 second
+        double t = static_cast<double>(index % 180) * dt;
+        Detections& detections = frames[index];
+        for (std::size_t ball = 0; ball < nb_balls; ball++)
+        {
+            for (std::size_t dim = 0; dim < 3; dim++)
+            {
+                detections[ball][dim] =
+                    starts[ball][dim] + velocities[ball][dim] * t;
+            }
+            detections[ball][2] -= 0.5 * g * t * t;
+        }
+        for (std::size_t s = 0; s < nb_spurious; s++)
+        {
+            detections[nb_balls + s] = {
+                uniform(generator), uniform(generator), uniform(generator)};
+        }
+        std::shuffle(detections.begin(),
+                     detections.begin() + nb_balls + nb_spurious,
+                     generator);
+    }
+    return frames;
+}
+
+static void benchmark(std::size_t nb_frames,
+                      std::size_t nb_balls,
+                      std::size_t nb_spurious)
+{
+    std::vector<Detections> frames =
+        create_frames(nb_frames, nb_balls, nb_spurious);
+    tennicam_client::DriverConfig config;
+    tennicam_client::MultiBallTracker tracker(config);
+    constexpr long int period_ns = 5555556;
+    std::size_t nb_tracks = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < nb_frames; index++)
+    {
+        // new throws
+        if (index % 180 == 0)
+        {
+            tracker.reset();
+        }
+        tracker.update(static_cast<long int>(index) * period_ns,
+                       frames[index].data(),
+                       nb_balls + nb_spurious);
+        nb_tracks += tracker.get_nb_tracks();
+    }
+    double duration = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    std::cout << nb_balls << " balls, " << nb_spurious
+              << " spurious detections: " << 1e9 * duration / nb_frames
+              << " ns per frame | average number of tracks: "
+              << static_cast<double>(nb_tracks) / nb_frames << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t nb_frames =
+        argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 100000;
+    std::cout << "\n" << nb_frames << " frames\n" << std::endl;
+    for (std::size_t nb_balls : {1, 2, 4, 8, 10})
+    {
+        benchmark(nb_frames, nb_balls, 0);
+    }
+    benchmark(nb_frames, 10, 2);
+    benchmark(nb_frames, 10, 6);
+    std::cout << std::endl;
+}
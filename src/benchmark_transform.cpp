@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "tennicam_client/transform.hpp"
+
+#ifdef TENNICAM_CLIENT_BENCHMARK_ARMADILLO
+#include <armadillo>
+
+// previous implementation of Transform (heap allocated armadillo vectors
+// and matrices), kept here for comparison
+class ArmadilloTransform
+{
+public:
+    ArmadilloTransform(std::array<double, 3> translation,
+                       std::array<double, 3> rotation)
+        : translation_(3), rotation_(3, 3), tmp_(3, arma::fill::zeros)
+    {
+        for (std::size_t index = 0; index < 3; index++)
+        {
+            translation_[index] = translation[index];
+        }
+        arma::Mat<double> Rx(3, 3, arma::fill::zeros);
+        Rx(0, 0) = 1;
+        Rx(1, 1) = +cos(rotation[0]);
+        Rx(1, 2) = -sin(rotation[0]);
+        Rx(2, 1) = +sin(rotation[0]);
+        Rx(2, 2) = +cos(rotation[0]);
+        arma::Mat<double> Ry(3, 3, arma::fill::zeros);
+        Ry(0, 0) = +cos(rotation[1]);
+        Ry(0, 2) = +sin(rotation[1]);
+        Ry(1, 1) = 1;
+        Ry(2, 0) = -sin(rotation[1]);
+        Ry(2, 2) = +cos(rotation[1]);
+        arma::Mat<double> Rz(3, 3, arma::fill::zeros);
+        Rz(0, 0) = +cos(rotation[2]);
+        Rz(0, 1) = -sin(rotation[2]);
+        Rz(1, 0) = +sin(rotation[2]);
+        Rz(1, 1) = +cos(rotation[2]);
+        Rz(2, 2) = 1;
+        rotation_ = Rz * Ry * Rx;
+    }
+    std::array<double, 3> apply(const std::array<double, 3>& v) const
+    {
+        for (std::size_t index = 0; index < 3; index++) tmp_[index] = v[index];
+        arma::vec transformed = rotation_ * tmp_ + translation_;
+        return std::array<double, 3>{
+            transformed[0], transformed[1], transformed[2]};
+    }
+
+private:
+    arma::vec translation_;
+    arma::mat rotation_;
+    mutable arma::vec tmp_;
+};
+#endif
+
+// Measures the cost of Transform::apply (and of the construction of
+// a Transform, performed at each iteration in active transform mode)
+
+template <class T>
+static void benchmark(const std::string& label,
+                      const std::vector<std::array<double, 3>>& points)
+{
+    std::array<double, 3> translation{0.1058, 3.1864, 0.453};
+    std::array<double, 3> rotation{0.1, -0.2, 0.3};
+    double checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < points.size(); index++)
+    {
+        T t(translation, rotation);
+        checksum += t.apply(points[index])[0];
+    }
+    double construction = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+
+    T t(translation, rotation);
+    start = std::chrono::steady_clock::now();
+    for (const std::array<double, 3>& point : points)
+    {
+        std::array<double, 3> out = t.apply(point);
+        checksum += out[0] + out[1] + out[2];
+    }
+    double apply = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+    std::cout << label << ": apply " << 1e9 * apply / points.size()
+              << " ns | construction + apply "
+              << 1e9 * construction / points.size()
+              << " ns (checksum: " << checksum << ")" << std::endl;
+}
+
+// Measures the cost per point of the batch API of Transform,
+// for both the (N,3) and the structure of arrays layouts
+
+static void benchmark_batch(const std::vector<std::array<double, 3>>& points,
+                            unsigned int nb_threads)
+{
+    std::array<double, 3> translation{0.1058, 3.1864, 0.453};
+    std::array<double, 3> rotation{0.1, -0.2, 0.3};
+    tennicam_client::Transform t(translation, rotation);
+    std::size_t nb_points = points.size();
+
+    std::vector<std::array<double, 3>> transformed(nb_points);
+    auto start = std::chrono::steady_clock::now();
+    t.apply(points[0].data(), transformed[0].data(), nb_points, nb_threads);
+    double interleaved = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+    std::vector<std::vector<double>> in(3, std::vector<double>(nb_points));
+    std::vector<std::vector<double>> out(3, std::vector<double>(nb_points));
+    for (std::size_t index = 0; index < nb_points; index++)
+    {
+        for (std::size_t dim = 0; dim < 3; dim++)
+        {
+            in[dim][index] = points[index][dim];
+        }
+    }
+    start = std::chrono::steady_clock::now();
+    t.apply(in[0].data(),
+            in[1].data(),
+            in[2].data(),
+            out[0].data(),
+            out[1].data(),
+            out[2].data(),
+            nb_points,
+            nb_threads);
+    double soa = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+
+    std::cout << "batch (" << nb_threads << " thread(s)): (N,3) "
+              << 1e9 * interleaved / nb_points << " ns | structure of arrays "
+              << 1e9 * soa / nb_points << " ns (checksum: "
+              << transformed.back()[0] + out[0].back() << ")" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t nb_points =
+        argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 1000000;
+    std::vector<std::array<double, 3>> points(nb_points);
+    for (std::size_t index = 0; index < nb_points; index++)
+    {
+        double d = static_cast<double>(index);
+        points[index] = {cos(d * 0.001), sin(d * 0.001), d * 1e-6};
+    }
+
+    std::cout << "\nper call cost (" << nb_points << " points)\n" << std::endl;
+    benchmark<tennicam_client::Transform>("Transform", points);
+#ifdef TENNICAM_CLIENT_BENCHMARK_ARMADILLO
+    benchmark<ArmadilloTransform>("armadillo (previous implementation)",
+                                  points);
+#else
+    std::cout << "(armadillo not found, previous implementation not "
+                 "benchmarked)"
+              << std::endl;
+#endif
+    unsigned int max_threads =
+        std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int nb_threads = 1; nb_threads <= max_threads;
+         nb_threads *= 2)
+    {
+        benchmark_batch(points, nb_threads);
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,189 @@
+#include "tennicam_client/clock_sync.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace tennicam_client
+{
+ClockOffset::ClockOffset()
+    : synchronized{false},
+      offset_ns{0},
+      drift{0},
+      reference_time_stamp{0},
+      nb_windows{0},
+      nb_resets{0}
+{
+}
+
+long int ClockOffset::to_local(long int remote) const
+{
+    if (!synchronized)
+    {
+        return remote;
+    }
+    const double elapsed = static_cast<double>(remote - reference_time_stamp);
+    return remote + offset_ns + static_cast<long int>(drift * 1e-6 * elapsed);
+}
+
+std::string ClockOffset::to_string() const
+{
+    std::stringstream s;
+    if (!synchronized)
+    {
+        s << "ClockOffset: not synchronized";
+        return s.str();
+    }
+    s << "ClockOffset: " << offset_ns << " ns "
+      << "| drift: " << drift << " ppm "
+      << "| windows: " << nb_windows << " "
+      << "| resets: " << nb_resets;
+    return s.str();
+}
+
+ClockSync::ClockSync(long int window_ns,
+                     std::size_t nb_windows,
+                     long int latency_ns,
+                     long int reset_threshold_ns)
+    : window_ns_{window_ns},
+      nb_windows_{nb_windows},
+      latency_ns_{latency_ns},
+      reset_threshold_ns_{reset_threshold_ns}
+{
+    if (window_ns <= 0)
+    {
+        throw std::invalid_argument(
+            "ClockSync: the duration of the windows should be positive");
+    }
+    if (nb_windows < 1 || nb_windows > TENNICAM_CLIENT_CLOCK_SYNC_MAX_WINDOWS)
+    {
+        throw std::invalid_argument(
+            std::string("ClockSync: the number of windows should be "
+                        "between 1 and ") +
+            std::to_string(TENNICAM_CLIENT_CLOCK_SYNC_MAX_WINDOWS));
+    }
+    reset();
+}
+
+void ClockSync::reset()
+{
+    window_start_ = -1;
+    head_ = 0;
+    size_ = 0;
+    long int nb_resets = offset_.nb_resets;
+    offset_ = ClockOffset();
+    offset_.nb_resets = nb_resets;
+}
+
+bool ClockSync::add(long int remote, long int local)
+{
+    const long int delay = local - remote;
+    if (window_start_ < 0)
+    {
+        window_start_ = remote;
+        window_remote_ = remote;
+        window_delay_ = delay;
+    }
+    else if (delay < window_delay_)
+    {
+        window_remote_ = remote;
+        window_delay_ = delay;
+    }
+    // until a first window is completed: offset from the minimal
+    // delay observed so far
+    if (size_ == 0)
+    {
+        offset_.synchronized = true;
+        offset_.offset_ns = window_delay_ - latency_ns_;
+        offset_.drift = 0;
+        offset_.reference_time_stamp = window_remote_;
+    }
+    // (the window also ends if the clock of tennicam went backward)
+    if (remote >= window_start_ && remote - window_start_ < window_ns_)
+    {
+        return size_ == 0;
+    }
+
+    // window completed
+    const long int expected =
+        offset_.to_local(window_remote_) - window_remote_ + latency_ns_;
+    if (size_ > 0 && std::abs(window_delay_ - expected) > reset_threshold_ns_)
+    {
+        offset_.nb_resets++;
+        head_ = 0;
+        size_ = 0;
+    }
+    remotes_[head_] = window_remote_;
+    delays_[head_] = window_delay_;
+    head_ = (head_ + 1) % nb_windows_;
+    size_ = std::min(size_ + 1, nb_windows_);
+    window_start_ = -1;
+    fit();
+    return true;
+}
+
+void ClockSync::fit()
+{
+    // least squares fit of delay = a + b * (remote - reference), the
+    // reference being the latest window (values relative to it, so that
+    // the sums do not lose precision)
+    const std::size_t latest = (head_ + nb_windows_ - 1) % nb_windows_;
+    const long int reference = remotes_[latest];
+    const long int reference_delay = delays_[latest];
+    double s_t = 0;
+    double s_tt = 0;
+    double s_d = 0;
+    double s_td = 0;
+    for (std::size_t i = 0; i < size_; i++)
+    {
+        const std::size_t index = (latest + nb_windows_ - i) % nb_windows_;
+        const double t = static_cast<double>(remotes_[index] - reference);
+        const double d = static_cast<double>(delays_[index] - reference_delay);
+        s_t += t;
+        s_tt += t * t;
+        s_d += d;
+        s_td += t * d;
+    }
+    const double n = static_cast<double>(size_);
+    const double det = n * s_tt - s_t * s_t;
+    double a = s_d / n;
+    double b = 0;
+    if (size_ >= 2 && det > 0)
+    {
+        b = (n * s_td - s_t * s_d) / det;
+        a = (s_d - b * s_t) / n;
+    }
+    offset_.synchronized = true;
+    offset_.offset_ns =
+        reference_delay + static_cast<long int>(a) - latency_ns_;
+    offset_.drift = b * 1e6;
+    offset_.reference_time_stamp = reference;
+    offset_.nb_windows = static_cast<long int>(size_);
+}
+
+const ClockOffset& ClockSync::get() const
+{
+    return offset_;
+}
+
+std::string clock_offset_segment_id(const std::string& segment_id)
+{
+    return segment_id + std::string("_clock_offset");
+}
+
+ClockOffsetReader::ClockOffsetReader(std::string segment_id)
+    : record_(clock_offset_segment_id(segment_id), SharedRecordMode::OPEN)
+{
+}
+
+ClockOffset ClockOffsetReader::get() const
+{
+    ClockOffset offset;
+    record_.get().read(offset);
+    return offset;
+}
+
+ClockOffset read_clock_offset(std::string segment_id)
+{
+    return ClockOffsetReader(segment_id).get();
+}
+
+}  // namespace tennicam_client
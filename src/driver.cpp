@@ -2,21 +2,35 @@
 
 namespace tennicam_client
 {
+// receive thread: timeout used to check if the thread should
+// stop, when no timeout is configured
+#define TENNICAM_CLIENT_IO_THREAD_POLL_MS 100
+
+namespace internal
+{
+static long int now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static THREAD_FUNCTION_RETURN_TYPE run_receive_thread_helper(void* arg)
+{
+    ((Driver*)arg)->run_receive_thread();
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+}  // namespace internal
+
 Driver::Driver(std::string toml_config_file,
                std::string active_transform_segment_id)
-    : config_{parse_toml(toml_config_file)},
-      transform_{config_.translation, config_.rotation},
-      ball_id_{-1},
-      previous_time_stamp_{-1},
-      active_transform_read_{false},
-      active_transform_segment_id_{active_transform_segment_id}
+    : Driver(parse_toml(toml_config_file))
 {
-    if (!active_transform_segment_id_.size() == 0)
+    if (!active_transform_segment_id.empty())
     {
-        active_transform_read_ = true;
-        write_transform_to_memory(active_transform_segment_id_,
-                                  config_.translation,
-                                  config_.rotation);
+        set_active_config_read(active_transform_segment_id);
+        active_transform_->get().write(config_.translation, config_.rotation);
     }
 }
 
@@ -28,34 +42,98 @@ Driver::Driver(std::string toml_config_file)
 Driver::Driver(const DriverConfig& config)
     : config_(config),
       transform_(config.translation, config.rotation),
+      estimator_{create_estimator(config)},
+      message_is_new_{false},
+      frame_nb_skipped_{0},
       ball_id_{-1},
       previous_time_stamp_{-1},
-      active_transform_read_{false}
+      outlier_time_stamp_{-1},
+      active_transform_read_{false},
+      active_transform_version_{0},
+      frame_statistics_{&local_frame_statistics_},
+      clock_offset_{&local_clock_offset_},
+      notified_ball_id_{-1},
+      latest_time_stamp_{-1},
+      running_{false}
 {
+    batch_.reserve(TENNICAM_CLIENT_BATCH_CAPACITY);
+    if (config_.segmentation)
+    {
+        segmenter_.emplace(config_.segmentation_velocity_change,
+                           config_.segmentation_hit_axis);
+    }
+    if (config_.gating)
+    {
+        gate_.emplace(config_.gating_max_speed,
+                      config_.gating_max_residual,
+                      config_.gating_max_consecutive_outliers,
+                      config_.gravity);
+    }
+    if (config_.multi_ball)
+    {
+        tracker_.emplace(config_);
+    }
+    if (config_.clock_sync)
+    {
+        clock_sync_.emplace(
+            static_cast<long int>(config_.clock_sync_window_ms * 1e6),
+            static_cast<std::size_t>(config_.clock_sync_nb_windows),
+            static_cast<long int>(config_.clock_sync_latency_ms * 1e6),
+            static_cast<long int>(config_.clock_sync_reset_threshold_ms *
+                                  1e6));
+    }
+    if (config_.latency_compensation)
+    {
+        extrapolator_.emplace(config_.gravity,
+                              config_.prediction_drag,
+                              config_.prediction_dt,
+                              config_.prediction_nb_steps,
+                              config_.prediction_plane_axis,
+                              config_.prediction_plane_position);
+    }
 }
 
 Driver::Driver(std::array<double, 3> translation,
                std::array<double, 3> rotation,
                std::string server_hostname,
                int server_port)
-    : config_{server_hostname, server_port, translation, rotation},
-      transform_{translation, rotation},
-      ball_id_{-1},
-      previous_time_stamp_{-1},
-      active_transform_read_{false}
+    : Driver(DriverConfig{server_hostname, server_port, translation, rotation})
 {
 }
 
+Driver::~Driver()
+{
+    stop();
+}
+
 void Driver::start()
 {
     context_ = std::make_unique<zmq::context_t>();
     socket_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_SUB);
     socket_->connect(config_.get_url());
     socket_->setsockopt(ZMQ_SUBSCRIBE, "", 0);
+
+    if (config_.io_thread)
+    {
+        queue_ = std::make_unique<ReceiveQueue>();
+        if (config_.io_thread_cpu >= 0)
+        {
+            thread_.parameters_.cpu_id_ =
+                std::vector<int>{config_.io_thread_cpu};
+        }
+        running_ = true;
+        thread_.create_realtime_thread(internal::run_receive_thread_helper,
+                                       (void*)this);
+    }
 }
 
 void Driver::stop()
 {
+    if (running_)
+    {
+        running_ = false;
+        thread_.join();
+    }
 }
 
 void Driver::set(const DriverIn&)
@@ -65,92 +143,583 @@ void Driver::set(const DriverIn&)
 std::array<double, 3> Driver::compute_velocity(
     long int time_stamp, const std::array<double, 3>& position)
 {
-    std::array<double, 3> v;
+    previous_time_stamp_ = time_stamp;
+    previous_position_ = position;
+    return estimator_->update(time_stamp, position);
+}
 
-    // can not perform finite differences
-    // if no previous iteration
-    if (previous_time_stamp_ < 0)
+void Driver::reset_velocity()
+{
+    previous_time_stamp_ = -1;
+    estimator_->reset();
+    if (segmenter_)
     {
-        previous_time_stamp_ = time_stamp;
-        previous_position_ = position;
-        v.fill(0);
-        return v;
+        segmenter_->reset();
     }
+}
 
-    double time_diff =
-        static_cast<double>(time_stamp - previous_time_stamp_) * 1e-9;
-    for (int i = 0; i < 3; i++)
+void Driver::reset_tracking()
+{
+    reset_velocity();
+    if (gate_)
     {
-        v[i] = (position[i] - previous_position_[i]) / time_diff;
+        gate_->reset();
     }
+}
 
-    previous_time_stamp_ = time_stamp;
-    previous_position_ = position;
+bool Driver::receive_spin()
+{
+    // note: when no new message is available, reply_ keeps
+    // the previous one
+    bool not_received = true;
+    while (not_received)
+    {
+        message_is_new_ = socket_->recv(&(reply_), ZMQ_NOBLOCK);
+        not_received = (reply_.size() == 0);
+    }
+    return true;
+}
+
+bool Driver::receive_poll(int timeout_ms)
+{
+    // short busy spin first, for low latency if a frame
+    // is about to arrive
+    if (config_.receive_spin_us > 0)
+    {
+        auto spin_end = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(config_.receive_spin_us);
+        while (std::chrono::steady_clock::now() < spin_end)
+        {
+            if (socket_->recv(&(reply_), ZMQ_NOBLOCK))
+            {
+                message_is_new_ = true;
+                return true;
+            }
+        }
+    }
 
-    return v;
+    // blocking (without using the CPU) until a new frame arrives
+    // or the timeout expires
+    zmq::pollitem_t item{static_cast<void*>(*socket_), 0, ZMQ_POLLIN, 0};
+    zmq::poll(&item, 1, static_cast<long>(timeout_ms));
+    if (item.revents & ZMQ_POLLIN)
+    {
+        message_is_new_ = socket_->recv(&(reply_), ZMQ_NOBLOCK);
+        return message_is_new_;
+    }
+    return false;
 }
 
-Ball Driver::get()
+long int Driver::drain()
 {
-    // if active_transform_read_ is true, then updating
-    // the transform with values written in the shared memory
-    // by the user
-    if (active_transform_read_)
+    // recv writes in reply_ only if a message is available.
+    // If reply_ is not a new message (ReceiveMode::SPIN, nothing
+    // received), the first message drained replaces it without
+    // being skipped
+    long int nb_skipped = message_is_new_ ? 0 : -1;
+    while (socket_->recv(&(reply_), ZMQ_NOBLOCK))
     {
-        std::tuple<std::array<double, 3>, std::array<double, 3>> t =
-            read_transform_from_memory(active_transform_segment_id_);
-        transform_ = Transform(std::get<0>(t), std::get<1>(t));
+        message_is_new_ = true;
+        nb_skipped++;
     }
+    nb_skipped = std::max(nb_skipped, 0L);
+    frame_statistics_->nb_skipped_frames.fetch_add(nb_skipped,
+                                                   std::memory_order_relaxed);
+    return nb_skipped;
+}
 
-    // receiving the ball information from zmq.
-    // zmq serialize the information into a json formatted string
-    bool not_received = true;
-    while (not_received)
+bool Driver::receive_pending()
+{
+    message_is_new_ = socket_->recv(&(reply_), ZMQ_NOBLOCK);
+    return message_is_new_;
+}
+
+bool Driver::receive()
+{
+    // the receive thread always waits for new frames, with
+    // a timeout so that it can be stopped
+    if (config_.io_thread)
     {
-        socket_->recv(&(reply_), ZMQ_NOBLOCK);
-        not_received = (reply_.size() == 0);
+        return receive_poll(config_.receive_timeout_ms >= 0
+                                ? config_.receive_timeout_ms
+                                : TENNICAM_CLIENT_IO_THREAD_POLL_MS);
+    }
+    switch (config_.receive_mode)
+    {
+        case ReceiveMode::POLL:
+            return receive_poll(config_.receive_timeout_ms);
+        case ReceiveMode::SPIN:
+        default:
+            return receive_spin();
     }
+}
+
+void Driver::decode_json()
+{
     std::string rpl =
         std::string(static_cast<char*>(reply_.data()), reply_.size());
     jh_.j = json::parse(rpl);
+    frame_.num = -1;
+    if (jh_.j.find("num") != jh_.j.end())
+    {
+        frame_.num = static_cast<long int>(jh_.j["num"]);
+    }
+    if (jh_.j.find("time") != jh_.j.end())
+    {
+        frame_.time_stamp = static_cast<long int>(jh_.j["time"]);
+    }
+    const json& obs = jh_.j["obs"];
+    frame_.nb_detections = 0;
+    frame_.detected = !obs.is_null() && !obs.empty();
+    if (!frame_.detected)
+    {
+        return;
+    }
+    // several balls detected: list of positions
+    if (obs[0].is_array())
+    {
+        frame_.nb_detections =
+            std::min<std::size_t>(obs.size(), TENNICAM_CLIENT_MAX_DETECTIONS);
+        for (std::size_t d = 0; d < frame_.nb_detections; d++)
+        {
+            for (std::size_t index = 0; index < 3; index++)
+            {
+                frame_.detections[d][index] =
+                    static_cast<double>(obs[d][index]);
+            }
+        }
+    }
+    else
+    {
+        frame_.nb_detections = 1;
+        for (std::size_t index = 0; index < 3; index++)
+        {
+            frame_.detections[0][index] = static_cast<double>(obs[index]);
+        }
+    }
+    frame_.position = frame_.detections[0];
+}
+
+void Driver::decode()
+{
+    const char* data = static_cast<const char*>(reply_.data());
+
+    // binary frames (auto detected from their first bytes)
+    if (is_binary_frame(data, reply_.size()))
+    {
+        if (!decode_binary_frame(data, reply_.size(), frame_))
+        {
+            throw std::runtime_error(
+                "tennicam_client: failed to decode binary frame");
+        }
+        return;
+    }
+
+    // fast path: the message has the layout expected from tennicam
+    if (parse_json_frame(data, reply_.size(), frame_))
+    {
+        return;
+    }
+    decode_json();
+}
+
+Ball Driver::process()
+{
     // zmq is not broadcasting any information
-    if (jh_.j["obs"].is_null())
+    if (!frame_.detected)
     {
         // previous observations should not be used
         // to compute the velocity
-        previous_time_stamp_ = -1;
+        reset_tracking();
         // this construct a ball with ball_id -1,
         // i.e. invalid ball
         return Ball();
     }
 
-    long int time_stamp = static_cast<long int>(jh_.j["time"]);
+    long int time_stamp = frame_.time_stamp;
 
     // if the time stamp did not change (i.e. same observation),
     // simply returning the previous observation
+    long int segment_id = segmenter_ ? segmenter_->get_segment_id() : -1;
     if (time_stamp == previous_time_stamp_)
     {
-        return Ball(
-            ball_id_, previous_position_, previous_velocity_, time_stamp);
+        Ball ball(ball_id_, previous_position_, previous_velocity_, time_stamp);
+        ball.set_segment(segment_id, 0);
+        return ball;
+    }
+    // same for an outlier
+    if (time_stamp == outlier_time_stamp_)
+    {
+        return outlier_ball_;
+    }
+
+    // updating the frame
+    std::array<double, 3> position = transform_.apply(frame_.position);
+
+    // rejecting (or flagging) false detections
+    if (gate_)
+    {
+        OutlierGate::Result result = gate_->check(time_stamp, position);
+        if (result == OutlierGate::OUTLIER)
+        {
+            frame_statistics_->nb_outliers.fetch_add(
+                1, std::memory_order_relaxed);
+            outlier_time_stamp_ = time_stamp;
+            if (config_.gating_reject)
+            {
+                // returning the previous ball again
+                outlier_ball_ = Ball(ball_id_,
+                                     previous_position_,
+                                     previous_velocity_,
+                                     previous_time_stamp_);
+                outlier_ball_.set_segment(segment_id, 0);
+            }
+            else
+            {
+                ball_id_++;
+                outlier_ball_ =
+                    Ball(ball_id_, position, previous_velocity_, time_stamp);
+                outlier_ball_.set_segment(segment_id, OUTLIER);
+            }
+            return outlier_ball_;
+        }
+        // the previous observations were not consistent
+        // with this one, they should not be used
+        if (result == OutlierGate::RESTARTED)
+        {
+            reset_velocity();
+        }
     }
 
     // otherwise updating all
     ball_id_++;
 
-    // parsing the json string
-    std::array<double, 3> position{static_cast<double>(jh_.j["obs"][0]),
-                                   static_cast<double>(jh_.j["obs"][1]),
-                                   static_cast<double>(jh_.j["obs"][2])};
-
-    // updating the frame
-    position = transform_.apply(position);
+    // bounce / hit detection
+    int events = 0;
+    if (segmenter_)
+    {
+        events = segmenter_->update(time_stamp, position);
+        segment_id = segmenter_->get_segment_id();
+        // the bounce / hit occurred at the previous observation:
+        // the velocity estimation restarts from there
+        if (events & (BOUNCE | HIT))
+        {
+            estimator_->reset();
+            estimator_->update(previous_time_stamp_, previous_position_);
+        }
+    }
 
-    // computing velocity (finite difference)
+    // computing velocity (see config_.estimator)
     // (note: this updates also previous_time_stamp_
     // and previous_position_)
     previous_velocity_ = compute_velocity(time_stamp, position);
+    if (gate_)
+    {
+        gate_->set_velocity(previous_velocity_);
+    }
 
-    return Ball(ball_id_, position, previous_velocity_, time_stamp);
+    Ball ball(ball_id_, position, previous_velocity_, time_stamp);
+    ball.set_segment(segment_id, events);
+    return ball;
+}
+
+bool Driver::read_ball(Ball& ball, StageTimings& timings, bool pending_only)
+{
+    // (timings may be reused from a previous call)
+    timings = StageTimings();
+
+    // if active_transform_read_ is true, then updating
+    // the transform with values written in the shared memory
+    // by the user
+    if (active_transform_read_)
+    {
+        update_active_transform();
+    }
+
+    // receiving the ball information from zmq.
+    // zmq serialize the information into a json formatted string
+    long int start = internal::now_ns();
+    bool received = pending_only ? receive_pending() : receive();
+    frame_nb_skipped_ = 0;
+    if (received && config_.ingestion_policy == IngestionPolicy::LATEST)
+    {
+        frame_nb_skipped_ = drain();
+    }
+    long int received_time = internal::now_ns();
+    // local clock used for the synchronization
+    long int local_time = clock_sync_ ? o80::time_now().count() : 0;
+    timings.receive_ns = received_time - start;
+    if (!received)
+    {
+        // no pending message, or receive thread polling without
+        // any configured timeout
+        if (pending_only || config_.receive_timeout_ms < 0)
+        {
+            return false;
+        }
+        // timeout: tennicam did not send anything. Previous
+        // observations should not be used to compute the velocity
+        frame_statistics_->nb_stalls.fetch_add(1, std::memory_order_relaxed);
+        reset_tracking();
+        if (tracker_)
+        {
+            tracker_->reset();
+        }
+        ball = Ball();
+        return true;
+    }
+
+    decode();
+    long int decoded_time = internal::now_ns();
+
+    // keeping track of lost / duplicated / reordered frames
+    if (message_is_new_ && frame_.num >= 0)
+    {
+        long int nb_lost;
+        SequenceTracker::Event event =
+            sequence_tracker_.update(frame_.num, frame_nb_skipped_, nb_lost);
+        frame_statistics_->add(event, frame_.num, nb_lost);
+    }
+
+    if (clock_sync_ && message_is_new_ && frame_.time_stamp >= 0)
+    {
+        if (clock_sync_->add(frame_.time_stamp, local_time))
+        {
+            clock_offset_->write(clock_sync_->get());
+        }
+    }
+
+    timings.decode_ns = decoded_time - received_time;
+
+    ball = process();
+    ball.set_nb_skipped_frames(frame_nb_skipped_);
+    to_local_time(ball);
+    if (tracker_ && message_is_new_)
+    {
+        update_tracks();
+    }
+    if (shared_prediction_)
+    {
+        update_prediction(ball);
+    }
+    timings.process_ns = internal::now_ns() - decoded_time;
+
+    return true;
+}
+
+void Driver::run_receive_thread()
+{
+    internal::ProcessedBall item;
+    while (running_)
+    {
+        if (!read_ball(item.ball, item.timings, false))
+        {
+            continue;
+        }
+        if (tracker_)
+        {
+            item.balls = tracker_->get_balls();
+            for (Ball& ball : item.balls)
+            {
+                to_local_time(ball);
+            }
+        }
+        item.push_time_ns = internal::now_ns();
+        if (!queue_->push(item))
+        {
+            frame_statistics_->nb_dropped.fetch_add(1,
+                                                    std::memory_order_relaxed);
+        }
+    }
+}
+
+Ball Driver::pop_ball()
+{
+    internal::ProcessedBall item;
+    long int nb_popped = 0;
+    long int nb_skipped = 0;
+    batch_.clear();
+    while (queue_->pop(item))
+    {
+        if (config_.ingestion_policy == IngestionPolicy::ALL)
+        {
+            batch_.push_back(item.ball);
+        }
+        timings_.add(item.timings);
+        timings_.hand_off.add(internal::now_ns() - item.push_time_ns);
+        // the ball popped at the previous iteration of this loop
+        // (and the frames it skipped) are skipped
+        if (nb_popped > 0)
+        {
+            nb_skipped += 1 + latest_ball_.get_nb_skipped_frames();
+        }
+        latest_ball_ = item.ball;
+        if (tracker_)
+        {
+            raw_balls_ = item.balls;
+        }
+        nb_popped++;
+    }
+    if (nb_popped == 0)
+    {
+        // returning the previous ball again
+        latest_ball_.set_nb_skipped_frames(0);
+        return latest_ball_;
+    }
+    if (nb_popped > 1 && config_.ingestion_policy != IngestionPolicy::ALL)
+    {
+        frame_statistics_->nb_skipped_frames.fetch_add(
+            nb_popped - 1, std::memory_order_relaxed);
+        latest_ball_.set_nb_skipped_frames(
+            latest_ball_.get_nb_skipped_frames() + nb_skipped);
+    }
+    return latest_ball_;
+}
+
+Ball Driver::read_batch()
+{
+    batch_.clear();
+    Ball ball;
+    StageTimings timings;
+    // in POLL mode: waiting for at least one new frame
+    // (SPIN mode: only the pending frames are read)
+    bool pending_only = config_.receive_mode != ReceiveMode::POLL;
+    while (read_ball(ball, timings, pending_only))
+    {
+        timings_.add(timings);
+        batch_.push_back(ball);
+        pending_only = true;
+    }
+    if (batch_.empty())
+    {
+        // no new frame, returning the previous ball again
+        return latest_ball_;
+    }
+    latest_ball_ = batch_.back();
+    return latest_ball_;
+}
+
+Ball Driver::fetch()
+{
+    if (config_.io_thread)
+    {
+        return pop_ball();
+    }
+    if (config_.ingestion_policy == IngestionPolicy::ALL)
+    {
+        return read_batch();
+    }
+    Ball ball;
+    StageTimings timings;
+    read_ball(ball, timings, false);
+    timings_.add(timings);
+    return ball;
+}
+
+Ball Driver::get()
+{
+    Ball ball = fetch();
+    if (tracker_)
+    {
+        // (with a receive thread, raw_balls_ is updated by pop_ball)
+        if (!config_.io_thread)
+        {
+            raw_balls_ = tracker_->get_balls();
+            for (Ball& b : raw_balls_)
+            {
+                to_local_time(b);
+            }
+        }
+        // (balls_ may be compensated below, raw_balls_ should not:
+        // the same tracks may be returned again at the next call)
+        balls_ = raw_balls_;
+    }
+    if (resampler_)
+    {
+        // all the observations (IngestionPolicy::ALL) are used for
+        // the resampling, but only the resampled ball is written
+        for (const Ball& b : batch_)
+        {
+            resampler_->add(b);
+        }
+        resampler_->add(ball);
+        batch_.clear();
+        ball = resampler_->sample();
+    }
+    for (Ball& b : batch_)
+    {
+        stamp(b);
+    }
+    stamp(ball);
+    if (extrapolator_)
+    {
+        // the ball(s) are written in the shared memory
+        // right after this method returns
+        long int now = o80::time_now().count();
+        for (Ball& b : batch_)
+        {
+            compensate_latency(b, now);
+        }
+        compensate_latency(ball, now);
+        for (Ball& b : balls_)
+        {
+            compensate_latency(b, now);
+        }
+    }
+    if (shared_new_ball_ && ball.get_ball_id() >= 0 &&
+        ball.get_ball_id() != notified_ball_id_)
+    {
+        notified_ball_id_ = ball.get_ball_id();
+        internal::notify_new_ball(shared_new_ball_->get(), ball);
+    }
+    return ball;
+}
+
+void Driver::stamp(Ball& ball)
+{
+    if (ball.get_ball_id() < 0)
+    {
+        ball.set_time_stamp(latest_time_stamp_);
+    }
+    else
+    {
+        latest_time_stamp_ = ball.get_time_stamp();
+    }
+}
+
+void Driver::set_frequency(double frequency)
+{
+    if (config_.resampling)
+    {
+        resampler_.emplace(frequency,
+                           config_.resampling_delay_ms * 1e-3,
+                           config_.resampling_max_extrapolation_ms * 1e-3,
+                           config_.resampling_resync_ms * 1e-3,
+                           config_.gravity);
+    }
+}
+
+void Driver::compensate_latency(Ball& ball, long int now) const
+{
+    if (!extrapolator_ || ball.get_ball_id() < 0)
+    {
+        return;
+    }
+    long int time_stamp =
+        now +
+        static_cast<long int>(config_.latency_compensation_extra_ms * 1e6);
+    double horizon =
+        static_cast<double>(time_stamp - ball.get_time_stamp()) * 1e-9;
+    // clocks not synchronized, or ball observed a long time ago
+    if (horizon <= 0 || horizon > config_.latency_compensation_max_ms * 1e-3)
+    {
+        return;
+    }
+    std::array<double, 3> position = ball.get_position();
+    std::array<double, 3> velocity = ball.get_velocity();
+    extrapolator_->integrate(position, velocity, horizon);
+    ball.set(position, velocity);
+    ball.set_compensated_time_stamp(time_stamp);
 }
 
 const DriverConfig& Driver::get_config() const
@@ -158,10 +727,166 @@ const DriverConfig& Driver::get_config() const
     return config_;
 }
 
+long int Driver::get_nb_stalls() const
+{
+    return frame_statistics_->nb_stalls.load(std::memory_order_relaxed);
+}
+
+long int Driver::get_nb_dropped() const
+{
+    return frame_statistics_->nb_dropped.load(std::memory_order_relaxed);
+}
+
+const Balls& Driver::get_balls() const
+{
+    return balls_;
+}
+
+long int Driver::get_nb_outliers() const
+{
+    return frame_statistics_->nb_outliers.load(std::memory_order_relaxed);
+}
+
+const std::vector<Ball>& Driver::get_batch() const
+{
+    return batch_;
+}
+
+long int Driver::get_nb_skipped_frames() const
+{
+    return frame_statistics_->nb_skipped_frames.load(
+        std::memory_order_relaxed);
+}
+
+FrameStatistics Driver::get_frame_statistics() const
+{
+    return frame_statistics_->get();
+}
+
+void Driver::publish_frame_statistics(std::string segment_id)
+{
+    shared_frame_statistics_ =
+        std::make_unique<SharedRecord<internal::AtomicFrameStatistics>>(
+            frame_statistics_segment_id(segment_id), SharedRecordMode::CREATE);
+    frame_statistics_ = &(shared_frame_statistics_->get());
+}
+
+void Driver::publish_prediction(std::string segment_id)
+{
+    if (!config_.predictor)
+    {
+        return;
+    }
+    predictor_.emplace(config_.gravity,
+                       config_.prediction_drag,
+                       config_.prediction_dt,
+                       config_.prediction_nb_steps,
+                       config_.prediction_plane_axis,
+                       config_.prediction_plane_position);
+    shared_prediction_ =
+        std::make_unique<SharedRecord<internal::PredictionRecord>>(
+            prediction_segment_id(segment_id), SharedRecordMode::CREATE);
+}
+
+void Driver::publish_new_balls(std::string segment_id)
+{
+    shared_new_ball_ =
+        std::make_unique<SharedRecord<internal::NewBallRecord>>(
+            new_ball_segment_id(segment_id), SharedRecordMode::CREATE);
+}
+
+void Driver::to_local_time(Ball& ball) const
+{
+    if (!clock_sync_ || !config_.clock_sync_rewrite || ball.get_ball_id() < 0)
+    {
+        return;
+    }
+    ball.set_time_stamp(clock_sync_->get().to_local(ball.get_time_stamp()));
+}
+
+void Driver::publish_clock_offset(std::string segment_id)
+{
+    if (!config_.clock_sync)
+    {
+        return;
+    }
+    shared_clock_offset_ =
+        std::make_unique<SharedRecord<internal::ClockOffsetRecord>>(
+            clock_offset_segment_id(segment_id), SharedRecordMode::CREATE);
+    clock_offset_ = &(shared_clock_offset_->get());
+}
+
+ClockOffset Driver::get_clock_offset() const
+{
+    ClockOffset offset;
+    clock_offset_->read(offset);
+    return offset;
+}
+
+void Driver::update_tracks()
+{
+    if (!frame_.detected)
+    {
+        tracker_->miss();
+        return;
+    }
+    std::array<std::array<double, 3>, TENNICAM_CLIENT_MAX_DETECTIONS>
+        positions;
+    for (std::size_t index = 0; index < frame_.nb_detections; index++)
+    {
+        positions[index] = transform_.apply(frame_.detections[index]);
+    }
+    tracker_->update(
+        frame_.time_stamp, positions.data(), frame_.nb_detections);
+}
+
+void Driver::update_prediction(const Ball& ball)
+{
+    // same ball as previously (or still no ball):
+    // the published prediction is up to date
+    if (ball.get_ball_id() == prediction_.ball_id)
+    {
+        return;
+    }
+    if (ball.get_ball_id() < 0)
+    {
+        prediction_ = Prediction();
+    }
+    else
+    {
+        predictor_->predict(ball, prediction_);
+    }
+    shared_prediction_->get().write(prediction_);
+}
+
+const DriverTimings& Driver::get_timings() const
+{
+    return timings_;
+}
+
 void Driver::set_active_config_read(std::string segment_id)
 {
-    active_transform_read_ = true;
     active_transform_segment_id_ = segment_id;
+    active_transform_ =
+        std::make_unique<SharedRecord<internal::TransformRecord>>(
+            transform_segment_id(segment_id),
+            SharedRecordMode::OPEN_OR_CREATE);
+    // version 0: nothing written yet, transform_ is kept as it is
+    active_transform_version_ = 0;
+    active_transform_read_ = true;
+}
+
+void Driver::update_active_transform()
+{
+    const internal::TransformRecord& record = active_transform_->get();
+    if (record.get_version() == active_transform_version_)
+    {
+        return;
+    }
+    std::array<double, 3> translation;
+    std::array<double, 3> rotation;
+    active_transform_version_ = record.read(translation, rotation);
+    transform_ = Transform(translation, rotation);
 }
 
 }  // namespace tennicam_client
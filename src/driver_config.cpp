@@ -24,6 +24,74 @@ std::string DriverConfig::get_url() const
     return s.str();
 }
 
+ReceiveMode to_receive_mode(const std::string& receive_mode)
+{
+    if (receive_mode == "spin")
+    {
+        return ReceiveMode::SPIN;
+    }
+    if (receive_mode == "poll")
+    {
+        return ReceiveMode::POLL;
+    }
+    throw std::invalid_argument(
+        std::string("unknown receive mode: ") + receive_mode +
+        std::string(" (expected 'spin' or 'poll')"));
+}
+
+IngestionPolicy to_ingestion_policy(const std::string& ingestion_policy)
+{
+    if (ingestion_policy == "single")
+    {
+        return IngestionPolicy::SINGLE;
+    }
+    if (ingestion_policy == "latest")
+    {
+        return IngestionPolicy::LATEST;
+    }
+    if (ingestion_policy == "all")
+    {
+        return IngestionPolicy::ALL;
+    }
+    throw std::invalid_argument(
+        std::string("unknown ingestion policy: ") + ingestion_policy +
+        std::string(" (expected 'single', 'latest' or 'all')"));
+}
+
+void check_history_size(int history_size)
+{
+    if (history_size != TENNICAM_CLIENT_HISTORY_SIZE_1K &&
+        history_size != TENNICAM_CLIENT_HISTORY_SIZE_10K &&
+        history_size != TENNICAM_CLIENT_HISTORY_SIZE_50K &&
+        history_size != TENNICAM_CLIENT_HISTORY_SIZE_500K)
+    {
+        throw std::invalid_argument(
+            std::string("unsupported history size: ") +
+            std::to_string(history_size) +
+            std::string(" (expected 1000, 10000, 50000 or 500000)"));
+    }
+}
+
+EstimatorType to_estimator_type(const std::string& estimator)
+{
+    if (estimator == "finite_difference")
+    {
+        return EstimatorType::FINITE_DIFFERENCE;
+    }
+    if (estimator == "kalman")
+    {
+        return EstimatorType::KALMAN;
+    }
+    if (estimator == "polynomial")
+    {
+        return EstimatorType::POLYNOMIAL;
+    }
+    throw std::invalid_argument(
+        std::string("unknown estimator: ") + estimator +
+        std::string(
+            " (expected 'finite_difference', 'kalman' or 'polynomial')"));
+}
+
 namespace internal
 {
 static std::array<double, 3> parse_toml_transform(
@@ -51,6 +119,16 @@ static T parse_toml_server(const toml::table& config_table,
     return opt_v.value();
 }
 
+// returns default_value if the field is not specified in the table
+template <class T>
+static T parse_toml_optional(const toml::table& config_table,
+                             const std::string& table,
+                             const std::string& field,
+                             T default_value)
+{
+    return config_table[table][field].value_or(default_value);
+}
+
 }  // namespace internal
 
 DriverConfig parse_toml(const std::string& toml_config_file)
@@ -64,16 +142,169 @@ DriverConfig parse_toml(const std::string& toml_config_file)
         config_table, std::string("hostname"));
     int port =
         internal::parse_toml_server<int>(config_table, std::string("port"));
-    return DriverConfig(hostname, port, translation, rotation);
+    DriverConfig config(hostname, port, translation, rotation);
+
+    config.receive_mode = to_receive_mode(internal::parse_toml_optional(
+        config_table, "server", "receive_mode", std::string("spin")));
+    config.receive_timeout_ms =
+        internal::parse_toml_optional(config_table,
+                                      "server",
+                                      "receive_timeout_ms",
+                                      config.receive_timeout_ms);
+    config.receive_spin_us = internal::parse_toml_optional(
+        config_table, "server", "receive_spin_us", config.receive_spin_us);
+    config.io_thread = internal::parse_toml_optional(
+        config_table, "driver", "io_thread", config.io_thread);
+    config.io_thread_cpu = internal::parse_toml_optional(
+        config_table, "driver", "io_thread_cpu", config.io_thread_cpu);
+    config.ingestion_policy = to_ingestion_policy(internal::parse_toml_optional(
+        config_table, "driver", "ingestion_policy", std::string("single")));
+    config.history_size = internal::parse_toml_optional(
+        config_table, "driver", "history_size", config.history_size);
+    check_history_size(config.history_size);
+    config.publish_on_change = internal::parse_toml_optional(
+        config_table, "driver", "publish_on_change", config.publish_on_change);
+    config.estimator = to_estimator_type(
+        internal::parse_toml_optional(config_table,
+                                      "estimator",
+                                      "type",
+                                      std::string("finite_difference")));
+    config.kalman_position_noise =
+        internal::parse_toml_optional(config_table,
+                                      "estimator",
+                                      "position_noise",
+                                      config.kalman_position_noise);
+    config.kalman_process_noise =
+        internal::parse_toml_optional(config_table,
+                                      "estimator",
+                                      "process_noise",
+                                      config.kalman_process_noise);
+    config.gravity = internal::parse_toml_optional(
+        config_table, "estimator", "gravity", config.gravity);
+    config.polynomial_window = internal::parse_toml_optional(
+        config_table, "estimator", "window", config.polynomial_window);
+    config.polynomial_order = internal::parse_toml_optional(
+        config_table, "estimator", "order", config.polynomial_order);
+    config.predictor = internal::parse_toml_optional(
+        config_table, "predictor", "enabled", config.predictor);
+    config.prediction_drag = internal::parse_toml_optional(
+        config_table, "predictor", "drag", config.prediction_drag);
+    config.prediction_dt = internal::parse_toml_optional(
+        config_table, "predictor", "dt", config.prediction_dt);
+    config.prediction_nb_steps = internal::parse_toml_optional(
+        config_table, "predictor", "nb_steps", config.prediction_nb_steps);
+    config.prediction_plane_axis =
+        internal::parse_toml_optional(config_table,
+                                      "predictor",
+                                      "plane_axis",
+                                      config.prediction_plane_axis);
+    config.prediction_plane_position =
+        internal::parse_toml_optional(config_table,
+                                      "predictor",
+                                      "plane_position",
+                                      config.prediction_plane_position);
+    config.segmentation = internal::parse_toml_optional(
+        config_table, "segmentation", "enabled", config.segmentation);
+    config.segmentation_velocity_change =
+        internal::parse_toml_optional(config_table,
+                                      "segmentation",
+                                      "velocity_change",
+                                      config.segmentation_velocity_change);
+    config.segmentation_hit_axis =
+        internal::parse_toml_optional(config_table,
+                                      "segmentation",
+                                      "hit_axis",
+                                      config.segmentation_hit_axis);
+    config.gating = internal::parse_toml_optional(
+        config_table, "gating", "enabled", config.gating);
+    config.gating_max_speed = internal::parse_toml_optional(
+        config_table, "gating", "max_speed", config.gating_max_speed);
+    config.gating_max_residual = internal::parse_toml_optional(
+        config_table, "gating", "max_residual", config.gating_max_residual);
+    config.gating_max_consecutive_outliers =
+        internal::parse_toml_optional(config_table,
+                                      "gating",
+                                      "max_consecutive_outliers",
+                                      config.gating_max_consecutive_outliers);
+    config.gating_reject = internal::parse_toml_optional(
+        config_table, "gating", "reject", config.gating_reject);
+    config.latency_compensation =
+        internal::parse_toml_optional(config_table,
+                                      "latency_compensation",
+                                      "enabled",
+                                      config.latency_compensation);
+    config.latency_compensation_extra_ms =
+        internal::parse_toml_optional(config_table,
+                                      "latency_compensation",
+                                      "extra_ms",
+                                      config.latency_compensation_extra_ms);
+    config.latency_compensation_max_ms =
+        internal::parse_toml_optional(config_table,
+                                      "latency_compensation",
+                                      "max_ms",
+                                      config.latency_compensation_max_ms);
+    config.multi_ball = internal::parse_toml_optional(
+        config_table, "multi_ball", "enabled", config.multi_ball);
+    config.multi_ball_max_distance =
+        internal::parse_toml_optional(config_table,
+                                      "multi_ball",
+                                      "max_distance",
+                                      config.multi_ball_max_distance);
+    config.multi_ball_max_missed =
+        internal::parse_toml_optional(config_table,
+                                      "multi_ball",
+                                      "max_missed",
+                                      config.multi_ball_max_missed);
+    config.clock_sync = internal::parse_toml_optional(
+        config_table, "clock_sync", "enabled", config.clock_sync);
+    config.clock_sync_window_ms =
+        internal::parse_toml_optional(config_table,
+                                      "clock_sync",
+                                      "window_ms",
+                                      config.clock_sync_window_ms);
+    config.clock_sync_nb_windows =
+        internal::parse_toml_optional(config_table,
+                                      "clock_sync",
+                                      "nb_windows",
+                                      config.clock_sync_nb_windows);
+    config.clock_sync_latency_ms =
+        internal::parse_toml_optional(config_table,
+                                      "clock_sync",
+                                      "latency_ms",
+                                      config.clock_sync_latency_ms);
+    config.clock_sync_reset_threshold_ms =
+        internal::parse_toml_optional(config_table,
+                                      "clock_sync",
+                                      "reset_threshold_ms",
+                                      config.clock_sync_reset_threshold_ms);
+    config.clock_sync_rewrite = internal::parse_toml_optional(
+        config_table, "clock_sync", "rewrite", config.clock_sync_rewrite);
+    config.resampling = internal::parse_toml_optional(
+        config_table, "resampling", "enabled", config.resampling);
+    config.resampling_delay_ms =
+        internal::parse_toml_optional(config_table,
+                                      "resampling",
+                                      "delay_ms",
+                                      config.resampling_delay_ms);
+    config.resampling_max_extrapolation_ms =
+        internal::parse_toml_optional(config_table,
+                                      "resampling",
+                                      "max_extrapolation_ms",
+                                      config.resampling_max_extrapolation_ms);
+    config.resampling_resync_ms =
+        internal::parse_toml_optional(config_table,
+                                      "resampling",
+                                      "resync_ms",
+                                      config.resampling_resync_ms);
+
+    return config;
 }
 
 namespace internal
 {
-static std::string str_array(const std::array<double, 3>& a)
+static toml::array toml_array(const std::array<double, 3>& a)
 {
-    std::ostringstream s;
-    s << "[" << a[0] << "," << a[1] << "," << a[2] << "]";
-    return s.str();
+    return toml::array{a[0], a[1], a[2]};
 }
 
 }  // namespace internal
@@ -82,15 +313,21 @@ void update_transform_config_file(std::string file_path,
                                   const std::array<double, 3>& translation,
                                   const std::array<double, 3>& rotation)
 {
-    DriverConfig config = parse_toml(file_path);
+    // updating the parsed table (rather than rewritting the file from
+    // scratch) so that all the other entries are preserved
+    toml::table config_table = toml::parse_file(file_path);
+    toml::table* transform = config_table["transform"].as_table();
+    if (transform == nullptr)
+    {
+        throw std::invalid_argument(
+            std::string("failed to find node transform in ") + file_path);
+    }
+    transform->insert_or_assign("translation",
+                                internal::toml_array(translation));
+    transform->insert_or_assign("rotation", internal::toml_array(rotation));
     std::ofstream os;
     os.open(file_path);
-    os << "[transform]" << std::endl
-       << "translation = " << internal::str_array(translation) << std::endl
-       << "rotation = " << internal::str_array(rotation) << std::endl
-       << "[server]" << std::endl
-       << "hostname = \"" << config.server_hostname << "\"" << std::endl
-       << "port = " << config.server_port << std::endl;
+    os << config_table << std::endl;
     os.close();
 }
 
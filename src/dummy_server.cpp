@@ -8,7 +8,15 @@ static THREAD_FUNCTION_RETURN_TYPE run_helper(void* arg)
     return THREAD_FUNCTION_RETURN_VALUE;
 }
 
-DummyServer::DummyServer(const DriverConfig& config) : running_{false}
+DummyServer::DummyServer(const DriverConfig& config,
+                         WireFormat wire_format,
+                         double frequency,
+                         double position_noise)
+    : wire_format_{wire_format},
+      period_{static_cast<long int>(1e9 / frequency + 0.5)},
+      noise_{0., position_noise},
+      noisy_{position_noise > 0},
+      running_{false}
 {
     context_ = std::make_unique<zmqpp::context>();
     auto socket_type = zmqpp::socket_type::pub;
@@ -26,6 +34,22 @@ DummyServer::~DummyServer()
 
 void DummyServer::perform(long int num, double x, double y, double z)
 {
+    if (wire_format_ == WireFormat::BINARY)
+    {
+        Frame frame;
+        frame.num = num;
+        frame.time_stamp = o80::time_now().count();
+        frame.proc_time = 1;
+        frame.detected = true;
+        frame.position = {x, y, z};
+        char buffer[binary_frame_size(1)];
+        std::size_t size = encode_binary_frame(frame, buffer);
+        zmqpp::message msg;
+        msg.add_raw(buffer, size);
+        socket_->send(msg);
+        return;
+    }
+
     json obs;
     obs.push_back(x);
     obs.push_back(y);
@@ -50,20 +74,30 @@ void DummyServer::stop()
     thread_.join();
 }
 
+std::array<double, 3> DummyServer::trajectory(long int num)
+{
+    double d = static_cast<double>(num + 1);
+    return {cos(0.001 * d), sin(0.001 * d), cos(-0.0005 * d)};
+}
+
 void DummyServer::run()
 {
     running_ = true;
     long int num = 0;
-    double x = 0;
-    double y = 0;
-    double z = 0;
+    auto next = std::chrono::steady_clock::now();
     while (running_)
     {
-        x += 0.001;
-        y += 0.001;
-        z -= 0.0005;
-        perform(num++, cos(x), sin(y), cos(z));
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::array<double, 3> position = trajectory(num);
+        if (noisy_)
+        {
+            for (double& p : position)
+            {
+                p += noise_(generator_);
+            }
+        }
+        perform(num++, position[0], position[1], position[2]);
+        next += period_;
+        std::this_thread::sleep_until(next);
     }
 }
 
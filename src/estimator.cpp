@@ -0,0 +1,368 @@
+#include "tennicam_client/estimator.hpp"
+
+namespace tennicam_client
+{
+FiniteDifference::FiniteDifference()
+{
+    reset();
+}
+
+void FiniteDifference::reset()
+{
+    previous_time_stamp_ = -1;
+    velocity_.fill(0);
+}
+
+std::array<double, 3> FiniteDifference::update(
+    long int time_stamp, const std::array<double, 3>& position)
+{
+    // can not perform finite differences
+    // if no previous iteration
+    if (previous_time_stamp_ < 0)
+    {
+        previous_time_stamp_ = time_stamp;
+        previous_position_ = position;
+        velocity_.fill(0);
+        return velocity_;
+    }
+
+    // jittery / duplicated time stamps: keeping the previous velocity
+    // rather than dividing by a zero (or negative) duration
+    if (time_stamp <= previous_time_stamp_)
+    {
+        return velocity_;
+    }
+
+    double time_diff =
+        static_cast<double>(time_stamp - previous_time_stamp_) * 1e-9;
+    for (int i = 0; i < 3; i++)
+    {
+        velocity_[i] = (position[i] - previous_position_[i]) / time_diff;
+    }
+
+    previous_time_stamp_ = time_stamp;
+    previous_position_ = position;
+
+    return velocity_;
+}
+
+namespace internal
+{
+// standard deviations of the initial velocity and acceleration
+// (around gravity) of the Kalman filter
+static constexpr double KALMAN_INITIAL_VELOCITY_STD = 10.;
+static constexpr double KALMAN_INITIAL_ACCELERATION_STD = 10.;
+}  // namespace internal
+
+KalmanFilter::KalmanFilter(double position_noise,
+                           double process_noise,
+                           double gravity)
+    : position_variance_{position_noise * position_noise},
+      process_noise_{process_noise},
+      gravity_{gravity}
+{
+    reset();
+}
+
+void KalmanFilter::reset()
+{
+    previous_time_stamp_ = -1;
+    for (std::size_t axis = 0; axis < 3; axis++)
+    {
+        x_[axis].fill(0);
+        for (std::array<double, 3>& row : p_[axis])
+        {
+            row.fill(0);
+        }
+    }
+}
+
+void KalmanFilter::predict(double dt)
+{
+    // F = [[1, dt, dt^2/2], [0, 1, dt], [0, 0, 1]]
+    // Q = q * [[dt^5/20, dt^4/8, dt^3/6],
+    //          [dt^4/8,  dt^3/3, dt^2/2],
+    //          [dt^3/6,  dt^2/2, dt    ]]
+    const double dt2 = dt * dt;
+    const double dt3 = dt2 * dt;
+    const double f[3][3] = {{1, dt, dt2 / 2.}, {0, 1, dt}, {0, 0, 1}};
+    const double q = process_noise_;
+    const double qm[3][3] = {
+        {q * dt3 * dt2 / 20., q * dt2 * dt2 / 8., q * dt3 / 6.},
+        {q * dt2 * dt2 / 8., q * dt3 / 3., q * dt2 / 2.},
+        {q * dt3 / 6., q * dt2 / 2., q * dt}};
+    for (std::size_t axis = 0; axis < 3; axis++)
+    {
+        State& x = x_[axis];
+        Covariance& p = p_[axis];
+        x[0] += dt * x[1] + 0.5 * dt2 * x[2];
+        x[1] += dt * x[2];
+        // P = F P F' + Q
+        double fp[3][3];
+        for (std::size_t i = 0; i < 3; i++)
+        {
+            for (std::size_t j = 0; j < 3; j++)
+            {
+                fp[i][j] =
+                    f[i][0] * p[0][j] + f[i][1] * p[1][j] + f[i][2] * p[2][j];
+            }
+        }
+        for (std::size_t i = 0; i < 3; i++)
+        {
+            for (std::size_t j = 0; j < 3; j++)
+            {
+                p[i][j] = fp[i][0] * f[j][0] + fp[i][1] * f[j][1] +
+                          fp[i][2] * f[j][2] + qm[i][j];
+            }
+        }
+    }
+}
+
+void KalmanFilter::correct(const std::array<double, 3>& position)
+{
+    // observation of the position only: H = [1, 0, 0]
+    for (std::size_t axis = 0; axis < 3; axis++)
+    {
+        State& x = x_[axis];
+        Covariance& p = p_[axis];
+        const double s = p[0][0] + position_variance_;
+        const double k[3] = {p[0][0] / s, p[1][0] / s, p[2][0] / s};
+        const double innovation = position[axis] - x[0];
+        const double p0[3] = {p[0][0], p[0][1], p[0][2]};
+        for (std::size_t i = 0; i < 3; i++)
+        {
+            x[i] += k[i] * innovation;
+            for (std::size_t j = 0; j < 3; j++)
+            {
+                p[i][j] -= k[i] * p0[j];
+            }
+        }
+    }
+}
+
+std::array<double, 3> KalmanFilter::update(
+    long int time_stamp, const std::array<double, 3>& position)
+{
+    if (previous_time_stamp_ < 0)
+    {
+        previous_time_stamp_ = time_stamp;
+        const double v0 = internal::KALMAN_INITIAL_VELOCITY_STD;
+        const double a0 = internal::KALMAN_INITIAL_ACCELERATION_STD;
+        for (std::size_t axis = 0; axis < 3; axis++)
+        {
+            x_[axis] = {position[axis], 0., 0.};
+            p_[axis] = {{{position_variance_, 0., 0.},
+                         {0., v0 * v0, 0.},
+                         {0., 0., a0 * a0}}};
+        }
+        x_[2][2] = -gravity_;
+        return get_velocity();
+    }
+    // jittery / duplicated time stamps: correction only
+    if (time_stamp > previous_time_stamp_)
+    {
+        predict(static_cast<double>(time_stamp - previous_time_stamp_) *
+                1e-9);
+        previous_time_stamp_ = time_stamp;
+    }
+    correct(position);
+    return get_velocity();
+}
+
+std::array<double, 3> KalmanFilter::get_position() const
+{
+    return {x_[0][0], x_[1][0], x_[2][0]};
+}
+
+std::array<double, 3> KalmanFilter::get_velocity() const
+{
+    return {x_[0][1], x_[1][1], x_[2][1]};
+}
+
+std::array<double, 3> KalmanFilter::get_acceleration() const
+{
+    return {x_[0][2], x_[1][2], x_[2][2]};
+}
+
+PolynomialFit::PolynomialFit(int window, int order)
+    : window_{static_cast<std::size_t>(window)}, order_{order}
+{
+    if (order != 1 && order != 2)
+    {
+        throw std::invalid_argument(
+            "PolynomialFit: order should be 1 or 2");
+    }
+    if (window < order + 1 || window > TENNICAM_CLIENT_POLYNOMIAL_MAX_WINDOW)
+    {
+        throw std::invalid_argument(
+            std::string("PolynomialFit: window should be between order+1 "
+                        "and ") +
+            std::to_string(TENNICAM_CLIENT_POLYNOMIAL_MAX_WINDOW));
+    }
+    reset();
+}
+
+void PolynomialFit::reset()
+{
+    head_ = 0;
+    size_ = 0;
+    nb_updates_ = 0;
+    reference_time_stamp_ = 0;
+    tau_sums_.fill(0);
+    for (std::array<double, 3>& sums : position_sums_)
+    {
+        sums.fill(0);
+    }
+    velocity_.fill(0);
+    acceleration_.fill(0);
+}
+
+void PolynomialFit::add(std::size_t index, double sign)
+{
+    const double tau =
+        static_cast<double>(time_stamps_[index] - reference_time_stamp_) *
+        1e-9;
+    double tau_k = sign;
+    for (std::size_t k = 0; k < 5; k++)
+    {
+        tau_sums_[k] += tau_k;
+        if (k < 3)
+        {
+            for (std::size_t axis = 0; axis < 3; axis++)
+            {
+                position_sums_[k][axis] += tau_k * positions_[index][axis];
+            }
+        }
+        tau_k *= tau;
+    }
+}
+
+void PolynomialFit::rebase()
+{
+    reference_time_stamp_ = time_stamps_[(head_ + window_ - 1) % window_];
+    tau_sums_.fill(0);
+    for (std::array<double, 3>& sums : position_sums_)
+    {
+        sums.fill(0);
+    }
+    for (std::size_t i = 0; i < size_; i++)
+    {
+        add((head_ + window_ - 1 - i) % window_, 1.);
+    }
+    nb_updates_ = 0;
+}
+
+void PolynomialFit::fit()
+{
+    const std::array<double, 5>& s = tau_sums_;
+    const std::array<std::array<double, 3>, 3>& b = position_sums_;
+    const double tau = static_cast<double>(
+                           time_stamps_[(head_ + window_ - 1) % window_] -
+                           reference_time_stamp_) *
+                       1e-9;
+    if (order_ == 2 && size_ >= 3)
+    {
+        // normal equations M c = b, M = [[s0, s1, s2], [s1, s2, s3],
+        // [s2, s3, s4]] (symmetric): inverse from the cofactors
+        const double c00 = s[2] * s[4] - s[3] * s[3];
+        const double c01 = s[2] * s[3] - s[1] * s[4];
+        const double c02 = s[1] * s[3] - s[2] * s[2];
+        const double c11 = s[0] * s[4] - s[2] * s[2];
+        const double c12 = s[1] * s[2] - s[0] * s[3];
+        const double c22 = s[0] * s[2] - s[1] * s[1];
+        const double det = s[0] * c00 + s[1] * c01 + s[2] * c02;
+        if (det > 1e-9 * s[0] * s[2] * s[4])
+        {
+            for (std::size_t axis = 0; axis < 3; axis++)
+            {
+                const double a1 =
+                    (c01 * b[0][axis] + c11 * b[1][axis] + c12 * b[2][axis]) /
+                    det;
+                const double a2 =
+                    (c02 * b[0][axis] + c12 * b[1][axis] + c22 * b[2][axis]) /
+                    det;
+                velocity_[axis] = a1 + 2. * a2 * tau;
+                acceleration_[axis] = 2. * a2;
+            }
+            return;
+        }
+    }
+    // linear fit: order 1, not enough observations for order 2,
+    // or (nearly) singular system
+    if (size_ < 2)
+    {
+        return;
+    }
+    const double det = s[0] * s[2] - s[1] * s[1];
+    if (det <= 1e-9 * s[0] * s[2])
+    {
+        return;
+    }
+    for (std::size_t axis = 0; axis < 3; axis++)
+    {
+        velocity_[axis] = (s[0] * b[1][axis] - s[1] * b[0][axis]) / det;
+        acceleration_[axis] = 0;
+    }
+}
+
+std::array<double, 3> PolynomialFit::update(
+    long int time_stamp, const std::array<double, 3>& position)
+{
+    if (size_ == 0)
+    {
+        reference_time_stamp_ = time_stamp;
+    }
+    // jittery / duplicated time stamps: the observation is ignored
+    else if (time_stamp <= time_stamps_[(head_ + window_ - 1) % window_])
+    {
+        return velocity_;
+    }
+    // window full: the oldest observation (to be overwritten)
+    // is removed
+    if (size_ == window_)
+    {
+        add(head_, -1.);
+        size_--;
+    }
+    time_stamps_[head_] = time_stamp;
+    positions_[head_] = position;
+    add(head_, 1.);
+    head_ = (head_ + 1) % window_;
+    size_++;
+    nb_updates_++;
+    if (nb_updates_ >= window_)
+    {
+        rebase();
+    }
+    fit();
+    return velocity_;
+}
+
+std::array<double, 3> PolynomialFit::get_velocity() const
+{
+    return velocity_;
+}
+
+std::array<double, 3> PolynomialFit::get_acceleration() const
+{
+    return acceleration_;
+}
+
+std::unique_ptr<Estimator> create_estimator(const DriverConfig& config)
+{
+    switch (config.estimator)
+    {
+        case EstimatorType::KALMAN:
+            return std::make_unique<KalmanFilter>(
+                config.kalman_position_noise,
+                config.kalman_process_noise,
+                config.gravity);
+        case EstimatorType::POLYNOMIAL:
+            return std::make_unique<PolynomialFit>(config.polynomial_window,
+                                                   config.polynomial_order);
+        default:
+            return std::make_unique<FiniteDifference>();
+    }
+}
+
+}  // namespace tennicam_client
@@ -0,0 +1,11 @@
+#include "tennicam_client/frame.hpp"
+
+namespace tennicam_client
+{
+Frame::Frame()
+    : num{-1}, time_stamp{-1}, proc_time{0}, detected{false}, nb_detections{0}
+{
+    position.fill(0);
+}
+
+}  // namespace tennicam_client
@@ -0,0 +1,277 @@
+#include "tennicam_client/frame_parser.hpp"
+#include <charconv>
+#include <cstring>
+
+namespace tennicam_client
+{
+namespace internal
+{
+// minimalistic cursor over the json formatted message
+class JsonCursor
+{
+public:
+    JsonCursor(const char* data, std::size_t size)
+        : current_{data}, end_{data + size}
+    {
+    }
+
+    void skip_whitespaces()
+    {
+        while (current_ < end_ && (*current_ == ' ' || *current_ == '\n' ||
+                                   *current_ == '\r' || *current_ == '\t'))
+        {
+            current_++;
+        }
+    }
+
+    // skips whitespaces, then returns true (and moves forward)
+    // if the next character is c
+    bool consume(char c)
+    {
+        skip_whitespaces();
+        if (current_ < end_ && *current_ == c)
+        {
+            current_++;
+            return true;
+        }
+        return false;
+    }
+
+    bool consume(const char* word)
+    {
+        skip_whitespaces();
+        std::size_t length = std::strlen(word);
+        if (static_cast<std::size_t>(end_ - current_) < length ||
+            std::memcmp(current_, word, length) != 0)
+        {
+            return false;
+        }
+        current_ += length;
+        return true;
+    }
+
+    // reads a string (escaped characters not supported),
+    // key points to the buffer (no copy)
+    bool string(const char*& key, std::size_t& length)
+    {
+        if (!consume('"'))
+        {
+            return false;
+        }
+        key = current_;
+        while (current_ < end_ && *current_ != '"')
+        {
+            if (*current_ == '\\')
+            {
+                return false;
+            }
+            current_++;
+        }
+        if (current_ == end_)
+        {
+            return false;
+        }
+        length = static_cast<std::size_t>(current_ - key);
+        current_++;
+        return true;
+    }
+
+    bool number(double& value)
+    {
+        skip_whitespaces();
+        auto [ptr, error] = std::from_chars(current_, end_, value);
+        if (error != std::errc())
+        {
+            return false;
+        }
+        current_ = ptr;
+        return true;
+    }
+
+    bool number(long int& value)
+    {
+        skip_whitespaces();
+        const char* start = current_;
+        auto [ptr, error] = std::from_chars(current_, end_, value);
+        if (error != std::errc())
+        {
+            return false;
+        }
+        current_ = ptr;
+        // the number is in fact written as a floating point
+        if (current_ < end_ &&
+            (*current_ == '.' || *current_ == 'e' || *current_ == 'E'))
+        {
+            double d;
+            current_ = start;
+            if (!number(d))
+            {
+                return false;
+            }
+            value = static_cast<long int>(d);
+        }
+        return true;
+    }
+
+    // skips whitespaces, then returns true if the next
+    // character is c (without moving forward)
+    bool peek(char c)
+    {
+        skip_whitespaces();
+        return current_ < end_ && *current_ == c;
+    }
+
+    bool at_end()
+    {
+        skip_whitespaces();
+        return current_ == end_;
+    }
+
+private:
+    const char* current_;
+    const char* end_;
+};
+
+static bool is_key(const char* key, std::size_t length, const char* expected)
+{
+    return length == std::strlen(expected) &&
+           std::memcmp(key, expected, length) == 0;
+}
+
+// reads the 3 numbers of a position, the opening bracket
+// being already consumed
+static bool parse_position(JsonCursor& cursor, std::array<double, 3>& position)
+{
+    for (std::size_t index = 0; index < 3; index++)
+    {
+        if (index > 0 && !cursor.consume(','))
+        {
+            return false;
+        }
+        if (!cursor.number(position[index]))
+        {
+            return false;
+        }
+    }
+    return cursor.consume(']');
+}
+
+static bool parse_obs(JsonCursor& cursor, Frame& frame)
+{
+    frame.nb_detections = 0;
+    if (cursor.consume("null"))
+    {
+        frame.detected = false;
+        return true;
+    }
+    if (!cursor.consume('['))
+    {
+        return false;
+    }
+    // single ball: [x, y, z]
+    if (!cursor.peek('['))
+    {
+        if (!parse_position(cursor, frame.detections[0]))
+        {
+            return false;
+        }
+        frame.nb_detections = 1;
+    }
+    // several balls: [[x, y, z], ...]
+    else
+    {
+        std::array<double, 3> ignored;
+        do
+        {
+            bool stored =
+                frame.nb_detections < TENNICAM_CLIENT_MAX_DETECTIONS;
+            if (!cursor.consume('[') ||
+                !parse_position(
+                    cursor,
+                    stored ? frame.detections[frame.nb_detections] : ignored))
+            {
+                return false;
+            }
+            if (stored)
+            {
+                frame.nb_detections++;
+            }
+        } while (cursor.consume(','));
+        if (!cursor.consume(']'))
+        {
+            return false;
+        }
+    }
+    frame.detected = true;
+    frame.position = frame.detections[0];
+    return true;
+}
+
+}  // namespace internal
+
+bool parse_json_frame(const char* data, std::size_t size, Frame& frame)
+{
+    internal::JsonCursor cursor(data, size);
+
+    bool num = false;
+    bool time = false;
+    bool obs = false;
+    frame.proc_time = 0;
+
+    if (!cursor.consume('{'))
+    {
+        return false;
+    }
+    if (cursor.consume('}'))
+    {
+        return false;
+    }
+
+    do
+    {
+        const char* key;
+        std::size_t length;
+        if (!cursor.string(key, length) || !cursor.consume(':'))
+        {
+            return false;
+        }
+        bool success;
+        if (internal::is_key(key, length, "num"))
+        {
+            success = cursor.number(frame.num);
+            num = true;
+        }
+        else if (internal::is_key(key, length, "time"))
+        {
+            success = cursor.number(frame.time_stamp);
+            time = true;
+        }
+        else if (internal::is_key(key, length, "proc_time"))
+        {
+            success = cursor.number(frame.proc_time);
+        }
+        else if (internal::is_key(key, length, "obs"))
+        {
+            success = internal::parse_obs(cursor, frame);
+            obs = true;
+        }
+        else
+        {
+            // unexpected layout
+            return false;
+        }
+        if (!success)
+        {
+            return false;
+        }
+    } while (cursor.consume(','));
+
+    if (!cursor.consume('}') || !cursor.at_end())
+    {
+        return false;
+    }
+
+    return num && time && obs;
+}
+
+}  // namespace tennicam_client
@@ -0,0 +1,149 @@
+#include "tennicam_client/frame_statistics.hpp"
+
+namespace tennicam_client
+{
+FrameStatistics::FrameStatistics()
+    : nb_frames{0},
+      last_num{-1},
+      nb_lost_frames{0},
+      nb_gaps{0},
+      nb_duplicates{0},
+      nb_reordered{0},
+      nb_skipped_frames{0},
+      nb_stalls{0},
+      nb_dropped{0},
+      nb_outliers{0}
+{
+}
+
+std::string FrameStatistics::to_string() const
+{
+    std::stringstream s;
+    s << "frames: " << nb_frames << " (last: " << last_num
+      << ") lost: " << nb_lost_frames << " gaps: " << nb_gaps
+      << " duplicates: " << nb_duplicates << " reordered: " << nb_reordered
+      << " skipped: " << nb_skipped_frames << " stalls: " << nb_stalls
+      << " dropped: " << nb_dropped << " outliers: " << nb_outliers;
+    return s.str();
+}
+
+SequenceTracker::SequenceTracker() : last_num_{-1}
+{
+}
+
+SequenceTracker::Event SequenceTracker::update(long int num,
+                                               long int nb_skipped,
+                                               long int& nb_lost)
+{
+    nb_lost = 0;
+    if (last_num_ < 0)
+    {
+        last_num_ = num;
+        return FIRST;
+    }
+    long int expected = last_num_ + 1 + nb_skipped;
+    if (num == expected)
+    {
+        last_num_ = num;
+        return IN_ORDER;
+    }
+    if (num == last_num_)
+    {
+        return DUPLICATE;
+    }
+    if (num < last_num_)
+    {
+        // last_num_ not updated, so that the frames
+        // received next are not counted as gaps
+        return REORDERED;
+    }
+    if (num < expected)
+    {
+        // can only happen if some of the skipped frames were
+        // duplicated or reordered, no way to know
+        last_num_ = num;
+        return IN_ORDER;
+    }
+    nb_lost = num - expected;
+    last_num_ = num;
+    return GAP;
+}
+
+namespace internal
+{
+AtomicFrameStatistics::AtomicFrameStatistics()
+    : nb_frames{0},
+      last_num{-1},
+      nb_lost_frames{0},
+      nb_gaps{0},
+      nb_duplicates{0},
+      nb_reordered{0},
+      nb_skipped_frames{0},
+      nb_stalls{0},
+      nb_dropped{0},
+      nb_outliers{0}
+{
+}
+
+void AtomicFrameStatistics::add(SequenceTracker::Event event,
+                                long int num,
+                                long int nb_lost)
+{
+    nb_frames.fetch_add(1, std::memory_order_relaxed);
+    last_num.store(num, std::memory_order_relaxed);
+    switch (event)
+    {
+        case SequenceTracker::GAP:
+            nb_gaps.fetch_add(1, std::memory_order_relaxed);
+            nb_lost_frames.fetch_add(nb_lost, std::memory_order_relaxed);
+            break;
+        case SequenceTracker::DUPLICATE:
+            nb_duplicates.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case SequenceTracker::REORDERED:
+            nb_reordered.fetch_add(1, std::memory_order_relaxed);
+            break;
+        default:
+            break;
+    }
+}
+
+FrameStatistics AtomicFrameStatistics::get() const
+{
+    FrameStatistics fs;
+    fs.nb_frames = nb_frames.load(std::memory_order_relaxed);
+    fs.last_num = last_num.load(std::memory_order_relaxed);
+    fs.nb_lost_frames = nb_lost_frames.load(std::memory_order_relaxed);
+    fs.nb_gaps = nb_gaps.load(std::memory_order_relaxed);
+    fs.nb_duplicates = nb_duplicates.load(std::memory_order_relaxed);
+    fs.nb_reordered = nb_reordered.load(std::memory_order_relaxed);
+    fs.nb_skipped_frames = nb_skipped_frames.load(std::memory_order_relaxed);
+    fs.nb_stalls = nb_stalls.load(std::memory_order_relaxed);
+    fs.nb_dropped = nb_dropped.load(std::memory_order_relaxed);
+    fs.nb_outliers = nb_outliers.load(std::memory_order_relaxed);
+    return fs;
+}
+
+}  // namespace internal
+
+std::string frame_statistics_segment_id(const std::string& segment_id)
+{
+    return segment_id + std::string("_frame_statistics");
+}
+
+FrameStatisticsReader::FrameStatisticsReader(std::string segment_id)
+    : record_(frame_statistics_segment_id(segment_id), SharedRecordMode::OPEN)
+{
+}
+
+FrameStatistics FrameStatisticsReader::get() const
+{
+    return record_.get().get();
+}
+
+FrameStatistics read_frame_statistics(std::string segment_id)
+{
+    return FrameStatisticsReader(segment_id).get();
+}
+
+}  // namespace tennicam_client
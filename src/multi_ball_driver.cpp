@@ -0,0 +1,58 @@
+#include "tennicam_client/multi_ball_driver.hpp"
+
+namespace tennicam_client
+{
+MultiBallDriver::MultiBallDriver(const DriverConfig& config) : driver_(config)
+{
+    check_config();
+}
+
+MultiBallDriver::MultiBallDriver(std::string toml_config_file)
+    : driver_(toml_config_file)
+{
+    check_config();
+}
+
+MultiBallDriver::MultiBallDriver(std::string toml_config_file,
+                                 std::string active_transform_segment_id)
+    : driver_(toml_config_file, active_transform_segment_id)
+{
+    check_config();
+}
+
+void MultiBallDriver::check_config() const
+{
+    if (!driver_.get_config().multi_ball)
+    {
+        throw std::invalid_argument(
+            "MultiBallDriver: multiple balls should be enabled in the "
+            "configuration ([multi_ball] section)");
+    }
+}
+
+void MultiBallDriver::start()
+{
+    driver_.start();
+}
+
+void MultiBallDriver::stop()
+{
+    driver_.stop();
+}
+
+void MultiBallDriver::set(const DriverIn&)
+{
+}
+
+Balls MultiBallDriver::get()
+{
+    driver_.get();
+    return driver_.get_balls();
+}
+
+tennicam_client::Driver& MultiBallDriver::get_driver()
+{
+    return driver_;
+}
+
+}  // namespace tennicam_client
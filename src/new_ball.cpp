@@ -0,0 +1,115 @@
+#include "tennicam_client/new_ball.hpp"
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <chrono>
+#include <climits>
+#include <ctime>
+
+namespace tennicam_client
+{
+namespace internal
+{
+NewBallRecord::NewBallRecord() : sequence{0}, nb_waiters{0}
+{
+}
+
+// (not FUTEX_PRIVATE_FLAG: the word may be shared between processes)
+void futex_wait(std::atomic<std::uint32_t>& word,
+                std::uint32_t expected,
+                long int timeout_ns)
+{
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ns / 1000000000;
+    timeout.tv_nsec = timeout_ns % 1000000000;
+    syscall(SYS_futex,
+            reinterpret_cast<std::uint32_t*>(&word),
+            FUTEX_WAIT,
+            expected,
+            &timeout,
+            nullptr,
+            0);
+}
+
+void futex_wake(std::atomic<std::uint32_t>& word)
+{
+    syscall(SYS_futex,
+            reinterpret_cast<std::uint32_t*>(&word),
+            FUTEX_WAKE,
+            INT_MAX,
+            nullptr,
+            nullptr,
+            0);
+}
+
+void notify_new_ball(NewBallRecord& record, const Ball& ball)
+{
+    record.ball.write(ball.to_record());
+    record.sequence.fetch_add(1, std::memory_order_seq_cst);
+    if (record.nb_waiters.load(std::memory_order_seq_cst) > 0)
+    {
+        futex_wake(record.sequence);
+    }
+}
+
+}  // namespace internal
+
+BallWaiter::BallWaiter(std::string segment_id)
+    : record_(new_ball_segment_id(segment_id), SharedRecordMode::OPEN),
+      ball_id_{latest().get_ball_id()}
+{
+}
+
+Ball BallWaiter::latest() const
+{
+    BallRecord record;
+    if (record_.get().ball.read(record) == 0)
+    {
+        return Ball();
+    }
+    return Ball(record);
+}
+
+bool BallWaiter::wait(long int timeout_us, Ball& ball)
+{
+    internal::NewBallRecord& record = record_.get();
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::microseconds(timeout_us);
+    record.nb_waiters.fetch_add(1, std::memory_order_seq_cst);
+    bool received = false;
+    while (true)
+    {
+        // loading the sequence before reading the ball: if a new ball
+        // is written after the read, the sequence will differ and
+        // futex_wait will return immediately
+        const std::uint32_t sequence =
+            record.sequence.load(std::memory_order_seq_cst);
+        Ball latest_ball = latest();
+        if (latest_ball.get_ball_id() >= 0 &&
+            latest_ball.get_ball_id() != ball_id_)
+        {
+            ball_id_ = latest_ball.get_ball_id();
+            ball = latest_ball;
+            received = true;
+            break;
+        }
+        const long int remaining =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                deadline - std::chrono::steady_clock::now())
+                .count();
+        if (remaining <= 0)
+        {
+            break;
+        }
+        internal::futex_wait(record.sequence, sequence, remaining);
+    }
+    record.nb_waiters.fetch_sub(1, std::memory_order_seq_cst);
+    return received;
+}
+
+std::string new_ball_segment_id(const std::string& segment_id)
+{
+    return segment_id + std::string("_new_ball");
+}
+
+}  // namespace tennicam_client
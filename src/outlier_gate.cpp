@@ -0,0 +1,86 @@
+#include "tennicam_client/outlier_gate.hpp"
+
+namespace tennicam_client
+{
+OutlierGate::OutlierGate(double max_speed,
+                         double max_residual,
+                         int max_consecutive_outliers,
+                         double gravity)
+    : max_speed_{max_speed},
+      max_residual_{max_residual},
+      max_consecutive_outliers_{max_consecutive_outliers},
+      gravity_{gravity}
+{
+    reset();
+}
+
+void OutlierGate::reset()
+{
+    nb_accepted_ = 0;
+    nb_consecutive_outliers_ = 0;
+    velocity_.fill(0);
+}
+
+void OutlierGate::accept(long int time_stamp,
+                         const std::array<double, 3>& position)
+{
+    nb_accepted_ = std::min(nb_accepted_ + 1, 2);
+    nb_consecutive_outliers_ = 0;
+    time_stamp_ = time_stamp;
+    position_ = position;
+}
+
+OutlierGate::Result OutlierGate::check(long int time_stamp,
+                                       const std::array<double, 3>& position)
+{
+    if (nb_accepted_ == 0)
+    {
+        accept(time_stamp, position);
+        return ACCEPTED;
+    }
+    // jittery / duplicated time stamps: can not be checked
+    if (time_stamp <= time_stamp_)
+    {
+        return ACCEPTED;
+    }
+    const double dt = static_cast<double>(time_stamp - time_stamp_) * 1e-9;
+    double distance2 = 0;
+    double residual2 = 0;
+    for (std::size_t dim = 0; dim < 3; dim++)
+    {
+        double predicted = position_[dim] + velocity_[dim] * dt;
+        if (dim == 2)
+        {
+            predicted -= 0.5 * gravity_ * dt * dt;
+        }
+        const double d = position[dim] - position_[dim];
+        const double r = position[dim] - predicted;
+        distance2 += d * d;
+        residual2 += r * r;
+    }
+    const double max_distance = max_speed_ * dt;
+    bool outlier = max_speed_ > 0 && distance2 > max_distance * max_distance;
+    // the velocity is known only after two accepted observations
+    outlier = outlier || (max_residual_ > 0 && nb_accepted_ >= 2 &&
+                          residual2 > max_residual_ * max_residual_);
+    if (!outlier)
+    {
+        accept(time_stamp, position);
+        return ACCEPTED;
+    }
+    nb_consecutive_outliers_++;
+    if (nb_consecutive_outliers_ > max_consecutive_outliers_)
+    {
+        reset();
+        accept(time_stamp, position);
+        return RESTARTED;
+    }
+    return OUTLIER;
+}
+
+void OutlierGate::set_velocity(const std::array<double, 3>& velocity)
+{
+    velocity_ = velocity;
+}
+
+}  // namespace tennicam_client
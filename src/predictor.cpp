@@ -0,0 +1,212 @@
+#include "tennicam_client/predictor.hpp"
+
+namespace tennicam_client
+{
+Prediction::Prediction()
+    : ball_id{-1},
+      time_stamp{-1},
+      dt{0},
+      nb_steps{0},
+      crosses_plane{false},
+      plane_time{-1}
+{
+    for (std::size_t index = 0; index < positions.size(); index++)
+    {
+        positions[index].fill(0);
+        velocities[index].fill(0);
+    }
+    plane_position.fill(0);
+    plane_velocity.fill(0);
+}
+
+std::string Prediction::to_string() const
+{
+    std::stringstream s;
+    if (ball_id < 0)
+    {
+        s << "no prediction";
+        return s.str();
+    }
+    s << "ball: " << ball_id << " (time stamp: " << time_stamp << ") ";
+    if (nb_steps > 0)
+    {
+        const std::array<double, 3>& p = positions[nb_steps - 1];
+        s << "position in " << nb_steps * dt << "s: (" << p[0] << ", "
+          << p[1] << ", " << p[2] << ") ";
+    }
+    if (crosses_plane)
+    {
+        s << "crosses plane in " << plane_time << "s at (" << plane_position[0]
+          << ", " << plane_position[1] << ", " << plane_position[2] << ")";
+    }
+    else
+    {
+        s << "does not cross plane";
+    }
+    return s.str();
+}
+
+Predictor::Predictor(double gravity,
+                     double drag,
+                     double dt,
+                     int nb_steps,
+                     int plane_axis,
+                     double plane_position)
+    : gravity_{gravity},
+      drag_{drag},
+      dt_{dt},
+      nb_steps_{nb_steps},
+      plane_axis_{plane_axis},
+      plane_position_{plane_position}
+{
+    if (dt <= 0)
+    {
+        throw std::invalid_argument("Predictor: dt should be positive");
+    }
+    if (nb_steps < 1 || nb_steps > TENNICAM_CLIENT_PREDICTION_MAX_STEPS)
+    {
+        throw std::invalid_argument(
+            std::string("Predictor: nb_steps should be between 1 and ") +
+            std::to_string(TENNICAM_CLIENT_PREDICTION_MAX_STEPS));
+    }
+    if (plane_axis < 0 || plane_axis > 2)
+    {
+        throw std::invalid_argument(
+            "Predictor: plane_axis should be 0 (x), 1 (y) or 2 (z)");
+    }
+    nb_substeps_ = static_cast<int>(
+        std::ceil(dt / TENNICAM_CLIENT_PREDICTION_MAX_SUBSTEP));
+}
+
+std::array<double, 3> Predictor::acceleration(
+    const std::array<double, 3>& velocity) const
+{
+    const double speed =
+        std::sqrt(velocity[0] * velocity[0] + velocity[1] * velocity[1] +
+                  velocity[2] * velocity[2]);
+    std::array<double, 3> a;
+    for (std::size_t dim = 0; dim < 3; dim++)
+    {
+        a[dim] = -drag_ * speed * velocity[dim];
+    }
+    a[2] -= gravity_;
+    return a;
+}
+
+void Predictor::step(std::array<double, 3>& position,
+                     std::array<double, 3>& velocity,
+                     double h) const
+{
+    // Runge-Kutta 4 (the acceleration depends on the velocity only)
+    std::array<double, 3> v2, v3, v4;
+    const std::array<double, 3> a1 = acceleration(velocity);
+    for (std::size_t dim = 0; dim < 3; dim++)
+    {
+        v2[dim] = velocity[dim] + 0.5 * h * a1[dim];
+    }
+    const std::array<double, 3> a2 = acceleration(v2);
+    for (std::size_t dim = 0; dim < 3; dim++)
+    {
+        v3[dim] = velocity[dim] + 0.5 * h * a2[dim];
+    }
+    const std::array<double, 3> a3 = acceleration(v3);
+    for (std::size_t dim = 0; dim < 3; dim++)
+    {
+        v4[dim] = velocity[dim] + h * a3[dim];
+    }
+    const std::array<double, 3> a4 = acceleration(v4);
+    for (std::size_t dim = 0; dim < 3; dim++)
+    {
+        position[dim] +=
+            h / 6. * (velocity[dim] + 2. * v2[dim] + 2. * v3[dim] + v4[dim]);
+        velocity[dim] +=
+            h / 6. * (a1[dim] + 2. * a2[dim] + 2. * a3[dim] + a4[dim]);
+    }
+}
+
+void Predictor::integrate(std::array<double, 3>& position,
+                          std::array<double, 3>& velocity,
+                          double duration) const
+{
+    int nb_substeps = static_cast<int>(
+        std::ceil(duration / TENNICAM_CLIENT_PREDICTION_MAX_SUBSTEP));
+    double h = duration / nb_substeps;
+    for (int substep = 0; substep < nb_substeps; substep++)
+    {
+        step(position, velocity, h);
+    }
+}
+
+void Predictor::predict(const Ball& ball, Prediction& prediction) const
+{
+    prediction.ball_id = ball.get_ball_id();
+    prediction.time_stamp = ball.get_time_stamp();
+    prediction.dt = dt_;
+    prediction.nb_steps = nb_steps_;
+    prediction.crosses_plane = false;
+    prediction.plane_time = -1;
+
+    std::array<double, 3> position = ball.get_position();
+    std::array<double, 3> velocity = ball.get_velocity();
+    const double h = dt_ / nb_substeps_;
+    double t = 0;
+    for (int s = 0; s < nb_steps_; s++)
+    {
+        for (int substep = 0; substep < nb_substeps_; substep++)
+        {
+            const std::array<double, 3> previous_position = position;
+            const std::array<double, 3> previous_velocity = velocity;
+            step(position, velocity, h);
+            const double d0 = previous_position[plane_axis_] - plane_position_;
+            const double d1 = position[plane_axis_] - plane_position_;
+            if (!prediction.crosses_plane && (d0 > 0) != (d1 > 0))
+            {
+                // linear interpolation within the substep
+                const double ratio = d0 / (d0 - d1);
+                prediction.crosses_plane = true;
+                prediction.plane_time = t + ratio * h;
+                for (std::size_t dim = 0; dim < 3; dim++)
+                {
+                    prediction.plane_position[dim] =
+                        previous_position[dim] +
+                        ratio * (position[dim] - previous_position[dim]);
+                    prediction.plane_velocity[dim] =
+                        previous_velocity[dim] +
+                        ratio * (velocity[dim] - previous_velocity[dim]);
+                }
+            }
+            t += h;
+        }
+        prediction.positions[s] = position;
+        prediction.velocities[s] = velocity;
+    }
+}
+
+std::string prediction_segment_id(const std::string& segment_id)
+{
+    return segment_id + std::string("_prediction");
+}
+
+PredictionReader::PredictionReader(std::string segment_id)
+    : record_(prediction_segment_id(segment_id), SharedRecordMode::OPEN)
+{
+}
+
+Prediction PredictionReader::get() const
+{
+    Prediction prediction;
+    read(prediction);
+    return prediction;
+}
+
+void PredictionReader::read(Prediction& prediction) const
+{
+    record_.get().read(prediction);
+}
+
+Prediction read_prediction(std::string segment_id)
+{
+    return PredictionReader(segment_id).get();
+}
+
+}  // namespace tennicam_client
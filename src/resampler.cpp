@@ -0,0 +1,138 @@
+#include "tennicam_client/resampler.hpp"
+#include "tennicam_client/state_query.hpp"
+#include <algorithm>
+
+namespace tennicam_client
+{
+Resampler::Resampler(double frequency,
+                     double delay,
+                     double max_extrapolation,
+                     double resync,
+                     double gravity)
+    : delay_ns_{static_cast<long int>(delay * 1e9)},
+      max_extrapolation_ns_{static_cast<long int>(max_extrapolation * 1e9)},
+      resync_ns_{static_cast<long int>(resync * 1e9)},
+      gravity_{gravity},
+      ball_id_{-1}
+{
+    if (frequency <= 0)
+    {
+        throw std::invalid_argument(
+            "Resampler: the frequency should be positive");
+    }
+    period_ns_ = 1e9 / frequency;
+    reset();
+}
+
+void Resampler::reset()
+{
+    head_ = 0;
+    size_ = 0;
+    new_observation_ = false;
+    pending_events_ = 0;
+    pending_nb_skipped_frames_ = 0;
+    anchored_ = false;
+    origin_ = 0;
+    tick_ = 0;
+}
+
+const Ball& Resampler::observation(std::size_t age) const
+{
+    const std::size_t size = TENNICAM_CLIENT_RESAMPLING_HISTORY;
+    return observations_[(head_ + size - 1 - age) % size];
+}
+
+void Resampler::add(const Ball& ball)
+{
+    if (ball.get_ball_id() < 0)
+    {
+        reset();
+        return;
+    }
+    // already added (or older than the latest observation)
+    if (size_ > 0 &&
+        (ball.get_ball_id() == observation(0).get_ball_id() ||
+         ball.get_time_stamp() <= observation(0).get_time_stamp()))
+    {
+        return;
+    }
+    const std::size_t size = TENNICAM_CLIENT_RESAMPLING_HISTORY;
+    observations_[head_] = ball;
+    head_ = (head_ + 1) % size;
+    size_ = std::min(size_ + 1, size);
+    new_observation_ = true;
+    pending_events_ |= ball.get_events();
+    pending_nb_skipped_frames_ += ball.get_nb_skipped_frames();
+}
+
+Ball Resampler::sample()
+{
+    if (size_ == 0)
+    {
+        return Ball();
+    }
+    const Ball& latest = observation(0);
+    const long int target = latest.get_time_stamp() - delay_ns_;
+    if (!anchored_)
+    {
+        anchored_ = true;
+        origin_ = target;
+        tick_ = 0;
+    }
+    else
+    {
+        tick_++;
+    }
+    long int time_stamp =
+        origin_ + std::lround(static_cast<double>(tick_) * period_ns_);
+    // checking the drift only when a new observation arrived (between
+    // observations, the time stamps move away from the target)
+    if (new_observation_ && std::abs(time_stamp - target) > resync_ns_)
+    {
+        origin_ = target;
+        tick_ = 0;
+        time_stamp = target;
+    }
+    new_observation_ = false;
+
+    BallState state;
+    if (time_stamp >= latest.get_time_stamp())
+    {
+        if (time_stamp - latest.get_time_stamp() > max_extrapolation_ns_)
+        {
+            return Ball();
+        }
+        internal::extrapolate(latest, time_stamp, gravity_, state);
+    }
+    else
+    {
+        // the observations before and after the time stamp
+        std::size_t age = 1;
+        while (age < size_ &&
+               observation(age).get_time_stamp() > time_stamp)
+        {
+            age++;
+        }
+        if (age == size_)
+        {
+            // older than all observations
+            internal::extrapolate(
+                observation(size_ - 1), time_stamp, gravity_, state);
+        }
+        else
+        {
+            internal::interpolate(
+                observation(age), observation(age - 1), time_stamp, state);
+        }
+    }
+
+    ball_id_++;
+    Ball ball(ball_id_, state.position, state.velocity, time_stamp);
+    ball.set_segment(latest.get_segment_id(), pending_events_);
+    ball.set_nb_skipped_frames(pending_nb_skipped_frames_);
+    pending_events_ = 0;
+    pending_nb_skipped_frames_ = 0;
+    return ball;
+}
+
+}  // namespace tennicam_client
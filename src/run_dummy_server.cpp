@@ -2,7 +2,7 @@
 #include <signal_handler/signal_handler.hpp>
 #include "tennicam_client/dummy_server.hpp"
 
-void execute()
+void execute(tennicam_client::WireFormat wire_format)
 {
     // writting tmp config file
     std::filesystem::path tmp_file = std::filesystem::temp_directory_path();
@@ -24,7 +24,7 @@ void execute()
     tennicam_client::DriverConfig config =
         tennicam_client::parse_toml(tmp_file.string());
 
-    tennicam_client::DummyServer server{config};
+    tennicam_client::DummyServer server{config, wire_format};
     server.start();
 
     signal_handler::SignalHandler::initialize();
@@ -39,7 +39,13 @@ void execute()
     }
 }
 
-int main()
+int main(int argc, char* argv[])
 {
-    execute();
+    // optional argument: "json" (default) or "binary"
+    tennicam_client::WireFormat wire_format = tennicam_client::WireFormat::JSON;
+    if (argc > 1)
+    {
+        wire_format = tennicam_client::to_wire_format(argv[1]);
+    }
+    execute(wire_format);
 }
@@ -0,0 +1,80 @@
+#include "tennicam_client/segmenter.hpp"
+
+namespace tennicam_client
+{
+TrajectorySegmenter::TrajectorySegmenter(double velocity_change_threshold,
+                                         int hit_axis)
+    : velocity_change_threshold_{velocity_change_threshold},
+      hit_axis_{hit_axis},
+      segment_id_{-1}
+{
+    if (hit_axis < 0 || hit_axis > 2)
+    {
+        throw std::invalid_argument(
+            "TrajectorySegmenter: hit_axis should be 0 (x), 1 (y) or 2 (z)");
+    }
+    reset();
+}
+
+void TrajectorySegmenter::reset()
+{
+    nb_observations_ = 0;
+}
+
+int TrajectorySegmenter::update(long int time_stamp,
+                                const std::array<double, 3>& position)
+{
+    if (nb_observations_ == 0)
+    {
+        segment_id_++;
+        nb_observations_ = 1;
+        previous_time_stamp_ = time_stamp;
+        previous_position_ = position;
+        return SEGMENT_START;
+    }
+    // jittery / duplicated time stamps: observation ignored
+    if (time_stamp <= previous_time_stamp_)
+    {
+        return 0;
+    }
+    const double dt =
+        static_cast<double>(time_stamp - previous_time_stamp_) * 1e-9;
+    std::array<double, 3> velocity;
+    double change = 0;
+    for (std::size_t dim = 0; dim < 3; dim++)
+    {
+        velocity[dim] = (position[dim] - previous_position_[dim]) / dt;
+        const double d = velocity[dim] - previous_velocity_[dim];
+        change += d * d;
+    }
+    int events = 0;
+    if (nb_observations_ >= 2 &&
+        change > velocity_change_threshold_ * velocity_change_threshold_)
+    {
+        if (previous_velocity_[2] < 0 && velocity[2] > 0)
+        {
+            events |= BOUNCE;
+        }
+        if ((previous_velocity_[hit_axis_] > 0) != (velocity[hit_axis_] > 0))
+        {
+            events |= HIT;
+        }
+        if (events != 0)
+        {
+            events |= SEGMENT_START;
+            segment_id_++;
+        }
+    }
+    nb_observations_ = 2;
+    previous_time_stamp_ = time_stamp;
+    previous_position_ = position;
+    previous_velocity_ = velocity;
+    return events;
+}
+
+long int TrajectorySegmenter::get_segment_id() const
+{
+    return segment_id_;
+}
+
+}  // namespace tennicam_client
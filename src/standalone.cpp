@@ -2,25 +2,306 @@
 
 namespace tennicam_client
 {
-Standalone::Standalone(std::shared_ptr<Driver> driver_ptr,
-                       double frequency,
-                       std::string segment_id)
+namespace internal
+{
+static o80::States<1, Ball> to_states(const Ball& ball)
+{
+    o80::States<1, Ball> balls;
+    balls.set(0, ball);
+    return balls;
+}
+
+static void publish_records(Driver& driver,
+                            const std::string& segment_id,
+                            int queue_size)
+{
+    // so that consumers know which frontend to instantiate
+    // (see read_history_size)
+    SharedRecord<int> history_size(history_size_segment_id(segment_id),
+                                   SharedRecordMode::CREATE);
+    history_size.get() = queue_size;
+    // frame statistics, new balls (and, if configured, predictions and
+    // clock offset) written next to the ball stream (see
+    // read_frame_statistics, BallWaiter, read_prediction and
+    // read_clock_offset)
+    driver.publish_frame_statistics(segment_id);
+    driver.publish_new_balls(segment_id);
+    driver.publish_prediction(segment_id);
+    driver.publish_clock_offset(segment_id);
+}
+
+static THREAD_FUNCTION_RETURN_TYPE run_publish_on_change_helper(void* arg)
+{
+    ((PublishOnChangeStandalone*)arg)->run();
+    return THREAD_FUNCTION_RETURN_VALUE;
+}
+
+}  // namespace internal
+
+template <int QUEUE_SIZE>
+StandaloneT<QUEUE_SIZE>::StandaloneT(std::shared_ptr<Driver> driver_ptr,
+                                     double frequency,
+                                     std::string segment_id)
+    : o80::Standalone<QUEUE_SIZE, 1, Driver, Ball, o80::VoidExtendedState>(
+          driver_ptr, frequency, segment_id)
+{
+    internal::publish_records(*driver_ptr, segment_id, QUEUE_SIZE);
+    // (used if the driver is configured with resampling)
+    driver_ptr->set_frequency(frequency);
+}
+
+template <int QUEUE_SIZE>
+o80::States<1, Ball> StandaloneT<QUEUE_SIZE>::convert(const Ball& ball)
+{
+    // IngestionPolicy::ALL: the driver may have read several balls
+    // during this iteration. All but the last one are written in the
+    // o80 history here (one backend iteration per ball). The last
+    // one is ball, which o80 writes once this method returns.
+    const std::vector<Ball>& batch = this->driver_ptr_->get_batch();
+    for (std::size_t index = 0; index + 1 < batch.size(); index++)
+    {
+        this->backend_.pulse(o80::time_now(),
+                             internal::to_states(batch[index]),
+                             o80::VoidExtendedState());
+    }
+    return internal::to_states(ball);
+}
+
+template <int QUEUE_SIZE>
+DriverIn StandaloneT<QUEUE_SIZE>::convert(const o80::States<1, Ball>&)
+{
+    return DriverIn();
+}
+
+template class StandaloneT<TENNICAM_CLIENT_HISTORY_SIZE_1K>;
+template class StandaloneT<TENNICAM_CLIENT_HISTORY_SIZE_10K>;
+template class StandaloneT<TENNICAM_CLIENT_HISTORY_SIZE_50K>;
+template class StandaloneT<TENNICAM_CLIENT_HISTORY_SIZE_500K>;
+
+PublishOnChangeStandalone::BackEnd::~BackEnd()
+{
+}
+
+template <int QUEUE_SIZE>
+class PublishOnChangeStandalone::BackEndT
+    : public PublishOnChangeStandalone::BackEnd
+{
+public:
+    BackEndT(std::string segment_id) : backend_(segment_id)
+    {
+    }
+    void pulse(const Ball& ball)
+    {
+        backend_.pulse(o80::time_now(),
+                       internal::to_states(ball),
+                       o80::VoidExtendedState());
+    }
+
+private:
+    o80::BackEnd<QUEUE_SIZE, 1, Ball, o80::VoidExtendedState> backend_;
+};
+
+PublishOnChangeStandalone::PublishOnChangeStandalone(
+    std::shared_ptr<Driver> driver_ptr,
+    std::string segment_id,
+    int history_size)
+    : driver_{driver_ptr}, ball_id_{-1}, nb_published_{0}, running_{false}
+{
+    const DriverConfig& config = driver_->get_config();
+    if (config.receive_mode != ReceiveMode::POLL || config.io_thread ||
+        config.receive_timeout_ms < 0 || config.resampling)
+    {
+        throw std::invalid_argument(
+            "PublishOnChangeStandalone: the driver should use the 'poll' "
+            "receive mode with a (non negative) receive timeout, without "
+            "receive thread and without resampling");
+    }
+    switch (history_size)
+    {
+        case TENNICAM_CLIENT_HISTORY_SIZE_1K:
+            backend_ = std::make_unique<
+                BackEndT<TENNICAM_CLIENT_HISTORY_SIZE_1K>>(segment_id);
+            break;
+        case TENNICAM_CLIENT_HISTORY_SIZE_10K:
+            backend_ = std::make_unique<
+                BackEndT<TENNICAM_CLIENT_HISTORY_SIZE_10K>>(segment_id);
+            break;
+        case TENNICAM_CLIENT_HISTORY_SIZE_50K:
+            backend_ = std::make_unique<
+                BackEndT<TENNICAM_CLIENT_HISTORY_SIZE_50K>>(segment_id);
+            break;
+        case TENNICAM_CLIENT_HISTORY_SIZE_500K:
+            backend_ = std::make_unique<
+                BackEndT<TENNICAM_CLIENT_HISTORY_SIZE_500K>>(segment_id);
+            break;
+        default:
+            check_history_size(history_size);
+    }
+    internal::publish_records(*driver_, segment_id, history_size);
+}
+
+PublishOnChangeStandalone::~PublishOnChangeStandalone()
+{
+    stop();
+}
+
+void PublishOnChangeStandalone::start()
+{
+    if (running_)
+    {
+        return;
+    }
+    driver_->start();
+    running_ = true;
+    thread_.create_realtime_thread(internal::run_publish_on_change_helper,
+                                   (void*)this);
+}
+
+void PublishOnChangeStandalone::stop()
+{
+    if (running_)
+    {
+        running_ = false;
+        thread_.join();
+        driver_->stop();
+    }
+}
+
+bool PublishOnChangeStandalone::is_running() const
+{
+    return running_;
+}
+
+long int PublishOnChangeStandalone::get_nb_published() const
+{
+    return nb_published_;
+}
+
+void PublishOnChangeStandalone::run()
+{
+    while (running_)
+    {
+        // blocks until a frame is received (or timeout)
+        Ball ball = driver_->get();
+        // IngestionPolicy::ALL: all the new balls read, the last one
+        // being ball
+        for (const Ball& b : driver_->get_batch())
+        {
+            publish(b);
+        }
+        publish(ball);
+    }
+}
+
+void PublishOnChangeStandalone::publish(const Ball& ball)
+{
+    if (ball.get_ball_id() == ball_id_)
+    {
+        return;
+    }
+    ball_id_ = ball.get_ball_id();
+    backend_->pulse(ball);
+    nb_published_++;
+}
+
+namespace internal
+{
+typedef std::map<std::string, std::unique_ptr<PublishOnChangeStandalone>>
+    PublishOnChangeStandalones;
+
+static PublishOnChangeStandalones& get_publish_on_change_standalones(
+    std::unique_lock<std::mutex>& lock)
+{
+    static std::mutex mutex;
+    static PublishOnChangeStandalones standalones;
+    lock = std::unique_lock<std::mutex>(mutex);
+    return standalones;
+}
+
+}  // namespace internal
+
+void start_publish_on_change_standalone(
+    std::string segment_id,
+    std::string toml_config_file,
+    std::string active_transform_segment_id,
+    int history_size)
+{
+    std::unique_lock<std::mutex> lock;
+    internal::PublishOnChangeStandalones& standalones =
+        internal::get_publish_on_change_standalones(lock);
+    if (standalones.find(segment_id) != standalones.end())
+    {
+        throw std::runtime_error(
+            std::string("a standalone is already running for segment_id ") +
+            segment_id);
+    }
+    std::shared_ptr<Driver> driver = std::make_shared<Driver>(
+        toml_config_file, active_transform_segment_id);
+    std::unique_ptr<PublishOnChangeStandalone> standalone =
+        std::make_unique<PublishOnChangeStandalone>(
+            driver, segment_id, history_size);
+    standalone->start();
+    standalones[segment_id] = std::move(standalone);
+}
+
+void stop_publish_on_change_standalone(std::string segment_id)
+{
+    std::unique_lock<std::mutex> lock;
+    internal::PublishOnChangeStandalones& standalones =
+        internal::get_publish_on_change_standalones(lock);
+    // (the destructor stops the standalone)
+    standalones.erase(segment_id);
+}
+
+bool is_publish_on_change_standalone_running(std::string segment_id)
+{
+    std::unique_lock<std::mutex> lock;
+    internal::PublishOnChangeStandalones& standalones =
+        internal::get_publish_on_change_standalones(lock);
+    auto it = standalones.find(segment_id);
+    return it != standalones.end() && it->second->is_running();
+}
+
+std::string history_size_segment_id(const std::string& segment_id)
+{
+    return segment_id + std::string("_history_size");
+}
+
+int read_history_size(std::string segment_id)
+{
+    SharedRecord<int> history_size(history_size_segment_id(segment_id),
+                                   SharedRecordMode::OPEN);
+    return history_size.get();
+}
+
+MultiBallStandalone::MultiBallStandalone(
+    std::shared_ptr<MultiBallDriver> driver_ptr,
+    double frequency,
+    std::string segment_id)
     : o80::Standalone<TENNICAM_CLIENT_QUEUE_SIZE,
-                      1,
-                      Driver,
+                      TENNICAM_CLIENT_MAX_BALLS,
+                      MultiBallDriver,
                       Ball,
-                      o80::VoidExtendedState>(driver_ptr, frequency, segment_id)
+                      o80::VoidExtendedState>(
+          driver_ptr, frequency, segment_id)
 {
+    driver_ptr->get_driver().publish_frame_statistics(segment_id);
+    driver_ptr->get_driver().publish_clock_offset(segment_id);
 }
 
-o80::States<1, Ball> Standalone::convert(const Ball& ball)
+o80::States<TENNICAM_CLIENT_MAX_BALLS, Ball> MultiBallStandalone::convert(
+    const Balls& balls)
 {
-    o80::States<1, Ball> balls;
-    balls.set(0, ball);
-    return balls;
+    o80::States<TENNICAM_CLIENT_MAX_BALLS, Ball> states;
+    for (std::size_t index = 0; index < balls.size(); index++)
+    {
+        states.set(index, balls[index]);
+    }
+    return states;
 }
 
-DriverIn Standalone::convert(const o80::States<1, Ball>&)
+DriverIn MultiBallStandalone::convert(
+    const o80::States<TENNICAM_CLIENT_MAX_BALLS, Ball>&)
 {
     return DriverIn();
 }
@@ -0,0 +1,181 @@
+#include "tennicam_client/state_query.hpp"
+
+namespace tennicam_client
+{
+BallState::BallState()
+    : ball_id{-1},
+      time_stamp{-1},
+      observation_time_stamp{-1},
+      extrapolated{false}
+{
+    position.fill(0);
+    velocity.fill(0);
+}
+
+std::string BallState::to_string() const
+{
+    std::stringstream s;
+    s << "BallState (ball " << ball_id << ") at " << time_stamp << " ("
+      << (extrapolated ? "extrapolated" : "interpolated") << ", "
+      << (time_stamp - observation_time_stamp) / 1000 << "us after "
+      << "observation) position: ";
+    for (const double& p : position)
+    {
+        s << std::setprecision(3) << p << " ";
+    }
+    s << "velocity: ";
+    for (const double& v : velocity)
+    {
+        s << std::setprecision(3) << v << " ";
+    }
+    return s.str();
+}
+
+namespace internal
+{
+void interpolate(const Ball& before,
+                 const Ball& after,
+                 long int time_stamp,
+                 BallState& state)
+{
+    const long int t0 = before.get_time_stamp();
+    const long int t1 = after.get_time_stamp();
+    const double h = static_cast<double>(t1 - t0) * 1e-9;
+    const double s = static_cast<double>(time_stamp - t0) /
+                     static_cast<double>(t1 - t0);
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+    // Hermite basis functions and their derivatives (w.r.t. time)
+    const double h00 = 2. * s3 - 3. * s2 + 1.;
+    const double h10 = s3 - 2. * s2 + s;
+    const double h01 = -2. * s3 + 3. * s2;
+    const double h11 = s3 - s2;
+    const double dh00 = (6. * s2 - 6. * s) / h;
+    const double dh10 = 3. * s2 - 4. * s + 1.;
+    const double dh01 = (-6. * s2 + 6. * s) / h;
+    const double dh11 = 3. * s2 - 2. * s;
+    const std::array<double, 3>& p0 = before.get_position();
+    const std::array<double, 3>& v0 = before.get_velocity();
+    const std::array<double, 3>& p1 = after.get_position();
+    const std::array<double, 3>& v1 = after.get_velocity();
+    for (std::size_t dim = 0; dim < 3; dim++)
+    {
+        state.position[dim] = h00 * p0[dim] + h10 * h * v0[dim] +
+                              h01 * p1[dim] + h11 * h * v1[dim];
+        state.velocity[dim] = dh00 * p0[dim] + dh10 * v0[dim] +
+                              dh01 * p1[dim] + dh11 * v1[dim];
+    }
+    state.ball_id = before.get_ball_id();
+    state.time_stamp = time_stamp;
+    state.observation_time_stamp = t0;
+    state.extrapolated = false;
+}
+
+void extrapolate(const Ball& ball,
+                 long int time_stamp,
+                 double gravity,
+                 BallState& state)
+{
+    const long int t0 = ball.get_compensated_time_stamp();
+    const double dt = static_cast<double>(time_stamp - t0) * 1e-9;
+    const std::array<double, 3>& p0 = ball.get_position();
+    const std::array<double, 3>& v0 = ball.get_velocity();
+    for (std::size_t dim = 0; dim < 3; dim++)
+    {
+        state.position[dim] = p0[dim] + v0[dim] * dt;
+        state.velocity[dim] = v0[dim];
+    }
+    state.position[2] -= 0.5 * gravity * dt * dt;
+    state.velocity[2] -= gravity * dt;
+    state.ball_id = ball.get_ball_id();
+    state.time_stamp = time_stamp;
+    state.observation_time_stamp = ball.get_time_stamp();
+    state.extrapolated = true;
+}
+
+Ball observed(const Ball& ball, double gravity)
+{
+    if (ball.get_compensated_time_stamp() == ball.get_time_stamp())
+    {
+        return ball;
+    }
+    BallState state;
+    extrapolate(ball, ball.get_time_stamp(), gravity, state);
+    Ball observed_ball = ball;
+    observed_ball.set(state.position, state.velocity);
+    observed_ball.set_compensated_time_stamp(ball.get_time_stamp());
+    return observed_ball;
+}
+
+}  // namespace internal
+
+StateQuery::History::~History()
+{
+}
+
+template <int QUEUE_SIZE>
+class StateQuery::FrontEndHistory : public StateQuery::History
+{
+public:
+    FrontEndHistory(std::string segment_id) : frontend_(segment_id)
+    {
+    }
+    long int latest()
+    {
+        return frontend_.latest().get_iteration();
+    }
+    Ball read(long int iteration)
+    {
+        return frontend_.read(iteration).get_observed_states().get(0);
+    }
+
+private:
+    o80::FrontEnd<QUEUE_SIZE, 1, Ball, o80::VoidExtendedState> frontend_;
+};
+
+StateQuery::StateQuery(std::string segment_id, double gravity)
+    : history_size_{read_history_size(segment_id)}, gravity_{gravity}
+{
+    switch (history_size_)
+    {
+        case TENNICAM_CLIENT_HISTORY_SIZE_1K:
+            history_ = std::make_unique<
+                FrontEndHistory<TENNICAM_CLIENT_HISTORY_SIZE_1K>>(segment_id);
+            break;
+        case TENNICAM_CLIENT_HISTORY_SIZE_10K:
+            history_ = std::make_unique<
+                FrontEndHistory<TENNICAM_CLIENT_HISTORY_SIZE_10K>>(segment_id);
+            break;
+        case TENNICAM_CLIENT_HISTORY_SIZE_50K:
+            history_ = std::make_unique<
+                FrontEndHistory<TENNICAM_CLIENT_HISTORY_SIZE_50K>>(segment_id);
+            break;
+        case TENNICAM_CLIENT_HISTORY_SIZE_500K:
+            history_ = std::make_unique<
+                FrontEndHistory<TENNICAM_CLIENT_HISTORY_SIZE_500K>>(
+                segment_id);
+            break;
+        default:
+            check_history_size(history_size_);
+    }
+}
+
+StateQuery::~StateQuery()
+{
+}
+
+bool StateQuery::get(long int time_stamp, BallState& state)
+{
+    const long int newest = history_->latest();
+    if (newest < 0)
+    {
+        return false;
+    }
+    // (the margin is at most a tenth of the history)
+    const long int margin = std::min(TENNICAM_CLIENT_STATE_QUERY_MARGIN,
+                                     history_size_ / 10);
+    const long int oldest = std::max(0L, newest - history_size_ + margin + 1);
+    return query_state(*history_, oldest, newest, time_stamp, gravity_, state);
+}
+
+}  // namespace tennicam_client
@@ -0,0 +1,87 @@
+#include "tennicam_client/timings.hpp"
+
+namespace tennicam_client
+{
+TimingStatistics::TimingStatistics()
+{
+    reset();
+}
+
+void TimingStatistics::add(long int duration_ns)
+{
+    count_++;
+    mean_ += (static_cast<double>(duration_ns) - mean_) /
+             static_cast<double>(count_);
+    max_ = std::max(max_, duration_ns);
+}
+
+void TimingStatistics::reset()
+{
+    count_ = 0;
+    mean_ = 0;
+    max_ = 0;
+}
+
+long int TimingStatistics::count() const
+{
+    return count_;
+}
+
+double TimingStatistics::mean() const
+{
+    return mean_;
+}
+
+long int TimingStatistics::max() const
+{
+    return max_;
+}
+
+StageTimings::StageTimings() : receive_ns{-1}, decode_ns{-1}, process_ns{-1}
+{
+}
+
+void DriverTimings::add(const StageTimings& stage_timings)
+{
+    // (stages not performed are not counted)
+    if (stage_timings.receive_ns >= 0)
+    {
+        receive.add(stage_timings.receive_ns);
+    }
+    if (stage_timings.decode_ns >= 0)
+    {
+        decode.add(stage_timings.decode_ns);
+    }
+    if (stage_timings.process_ns >= 0)
+    {
+        process.add(stage_timings.process_ns);
+    }
+}
+
+void DriverTimings::reset()
+{
+    receive.reset();
+    decode.reset();
+    process.reset();
+    hand_off.reset();
+}
+
+std::string DriverTimings::to_string() const
+{
+    std::stringstream s;
+    auto print = [&s](const std::string& label, const TimingStatistics& ts)
+    {
+        s << label << ": " << ts.mean() * 1e-3 << "us (mean) "
+          << static_cast<double>(ts.max()) * 1e-3 << "us (max) ";
+    };
+    print("receive", receive);
+    print("decode", decode);
+    print("process", process);
+    if (hand_off.count() > 0)
+    {
+        print("hand off", hand_off);
+    }
+    return s.str();
+}
+
+}  // namespace tennicam_client
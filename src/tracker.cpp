@@ -0,0 +1,278 @@
+#include "tennicam_client/tracker.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace tennicam_client
+{
+namespace internal
+{
+void assign(const CostMatrix& cost,
+            std::size_t n,
+            std::array<std::size_t, MAX_ASSOCIATION>& assignment)
+{
+    // potentials (u: rows, v: columns), and for each column the row it
+    // is assigned to (p) and the previous column of the augmenting path
+    // (way). Indexes start at 1, 0 being a virtual column.
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    std::array<double, MAX_ASSOCIATION + 1> u;
+    std::array<double, MAX_ASSOCIATION + 1> v;
+    std::array<double, MAX_ASSOCIATION + 1> min_v;
+    std::array<std::size_t, MAX_ASSOCIATION + 1> p;
+    std::array<std::size_t, MAX_ASSOCIATION + 1> way;
+    std::array<bool, MAX_ASSOCIATION + 1> used;
+    u.fill(0);
+    v.fill(0);
+    p.fill(0);
+    way.fill(0);
+    for (std::size_t i = 1; i <= n; i++)
+    {
+        p[0] = i;
+        std::size_t j0 = 0;
+        min_v.fill(inf);
+        used.fill(false);
+        do
+        {
+            used[j0] = true;
+            const std::size_t i0 = p[j0];
+            double delta = inf;
+            std::size_t j1 = 0;
+            for (std::size_t j = 1; j <= n; j++)
+            {
+                if (used[j])
+                {
+                    continue;
+                }
+                const double c = cost[i0 - 1][j - 1] - u[i0] - v[j];
+                if (c < min_v[j])
+                {
+                    min_v[j] = c;
+                    way[j] = j0;
+                }
+                if (min_v[j] < delta)
+                {
+                    delta = min_v[j];
+                    j1 = j;
+                }
+            }
+            for (std::size_t j = 0; j <= n; j++)
+            {
+                if (used[j])
+                {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                }
+                else
+                {
+                    min_v[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+        // augmenting path
+        do
+        {
+            const std::size_t j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+    for (std::size_t j = 1; j <= n; j++)
+    {
+        assignment[p[j] - 1] = j - 1;
+    }
+}
+
+}  // namespace internal
+
+MultiBallTracker::MultiBallTracker(const DriverConfig& config)
+    : max_distance_{config.multi_ball_max_distance},
+      max_missed_{config.multi_ball_max_missed},
+      gravity_{config.gravity},
+      nb_started_tracks_{0}
+{
+    // the ball ids of a slot keep increasing across tracks
+    ball_ids_.fill(-1);
+    for (Track& track : tracks_)
+    {
+        track.estimator = create_estimator(config);
+    }
+    reset();
+}
+
+void MultiBallTracker::reset()
+{
+    time_stamp_ = -1;
+    for (std::size_t slot = 0; slot < tracks_.size(); slot++)
+    {
+        close(slot);
+    }
+}
+
+void MultiBallTracker::close(std::size_t slot)
+{
+    tracks_[slot].active = false;
+    tracks_[slot].estimator->reset();
+    // invalid ball (ball_id -1)
+    balls_[slot] = Ball();
+}
+
+void MultiBallTracker::observe(std::size_t slot,
+                               long int time_stamp,
+                               const std::array<double, 3>& position,
+                               int events)
+{
+    Track& track = tracks_[slot];
+    track.time_stamp = time_stamp;
+    track.position = position;
+    track.velocity = track.estimator->update(time_stamp, position);
+    track.nb_missed = 0;
+    if (events & SEGMENT_START)
+    {
+        track.track_id = nb_started_tracks_;
+        nb_started_tracks_++;
+    }
+    ball_ids_[slot]++;
+    balls_[slot] = Ball(ball_ids_[slot], position, track.velocity, time_stamp);
+    balls_[slot].set_segment(track.track_id, events);
+}
+
+void MultiBallTracker::miss()
+{
+    for (std::size_t slot = 0; slot < tracks_.size(); slot++)
+    {
+        Track& track = tracks_[slot];
+        if (track.active)
+        {
+            track.nb_missed++;
+            if (track.nb_missed > max_missed_)
+            {
+                close(slot);
+            }
+        }
+    }
+}
+
+void MultiBallTracker::update(long int time_stamp,
+                              const std::array<double, 3>* positions,
+                              std::size_t nb_positions)
+{
+    if (time_stamp <= time_stamp_)
+    {
+        return;
+    }
+    time_stamp_ = time_stamp;
+    nb_positions =
+        std::min<std::size_t>(nb_positions, TENNICAM_CLIENT_MAX_DETECTIONS);
+
+    // active tracks
+    std::array<std::size_t, TENNICAM_CLIENT_MAX_BALLS> slots;
+    std::size_t nb_tracks = 0;
+    for (std::size_t slot = 0; slot < tracks_.size(); slot++)
+    {
+        if (tracks_[slot].active)
+        {
+            slots[nb_tracks] = slot;
+            nb_tracks++;
+        }
+    }
+
+    // squared distances between predicted and detected positions,
+    // capped to max_distance^2 (which is also the cost of the
+    // padding rows / columns, i.e. of not associating)
+    const double max_cost = max_distance_ * max_distance_;
+    const std::size_t n = std::max(nb_tracks, nb_positions);
+    internal::CostMatrix cost;
+    for (std::size_t t = 0; t < n; t++)
+    {
+        std::array<double, 3> predicted;
+        if (t < nb_tracks)
+        {
+            const Track& track = tracks_[slots[t]];
+            const double dt =
+                static_cast<double>(time_stamp - track.time_stamp) * 1e-9;
+            for (std::size_t dim = 0; dim < 3; dim++)
+            {
+                predicted[dim] =
+                    track.position[dim] + track.velocity[dim] * dt;
+            }
+            predicted[2] -= 0.5 * gravity_ * dt * dt;
+        }
+        for (std::size_t d = 0; d < n; d++)
+        {
+            if (t >= nb_tracks || d >= nb_positions)
+            {
+                cost[t][d] = max_cost;
+                continue;
+            }
+            double distance2 = 0;
+            for (std::size_t dim = 0; dim < 3; dim++)
+            {
+                const double diff = positions[d][dim] - predicted[dim];
+                distance2 += diff * diff;
+            }
+            cost[t][d] = std::min(distance2, max_cost);
+        }
+    }
+    std::array<std::size_t, internal::MAX_ASSOCIATION> assignment;
+    internal::assign(cost, n, assignment);
+
+    std::array<bool, TENNICAM_CLIENT_MAX_DETECTIONS> associated;
+    associated.fill(false);
+    for (std::size_t t = 0; t < nb_tracks; t++)
+    {
+        const std::size_t d = assignment[t];
+        const std::size_t slot = slots[t];
+        if (d < nb_positions && cost[t][d] < max_cost)
+        {
+            associated[d] = true;
+            observe(slot, time_stamp, positions[d], 0);
+            continue;
+        }
+        tracks_[slot].nb_missed++;
+        if (tracks_[slot].nb_missed > max_missed_)
+        {
+            close(slot);
+        }
+    }
+
+    // new tracks, in the free slots
+    std::size_t slot = 0;
+    for (std::size_t d = 0; d < nb_positions; d++)
+    {
+        if (associated[d])
+        {
+            continue;
+        }
+        while (slot < tracks_.size() && tracks_[slot].active)
+        {
+            slot++;
+        }
+        if (slot == tracks_.size())
+        {
+            // all slots used: detection ignored
+            break;
+        }
+        tracks_[slot].active = true;
+        observe(slot, time_stamp, positions[d], SEGMENT_START);
+    }
+}
+
+const Balls& MultiBallTracker::get_balls() const
+{
+    return balls_;
+}
+
+std::size_t MultiBallTracker::get_nb_tracks() const
+{
+    std::size_t nb_tracks = 0;
+    for (const Track& track : tracks_)
+    {
+        if (track.active)
+        {
+            nb_tracks++;
+        }
+    }
+    return nb_tracks;
+}
+
+}  // namespace tennicam_client
@@ -1,90 +1,212 @@
 #include "tennicam_client/transform.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 namespace tennicam_client
 {
-Transform::Transform(std::array<double, 3> translation,
-                     std::array<double, 3> rotation)
-    : translation_(3), rotation_(3, 3), tmp_(3, arma::fill::zeros)
+namespace internal
 {
-    translation_[0] = translation[0];
-    translation_[1] = translation[1];
-    translation_[2] = translation[2];
-
-    arma::Mat<double> Rx(3, 3, arma::fill::zeros);
-    Rx(0, 0) = 1;
-    Rx(1, 1) = +cos(rotation[0]);
-    Rx(1, 2) = -sin(rotation[0]);
-    Rx(2, 1) = +sin(rotation[0]);
-    Rx(2, 2) = +cos(rotation[0]);
-
-    arma::Mat<double> Ry(3, 3, arma::fill::zeros);
-    Ry(0, 0) = +cos(rotation[1]);
-    Ry(0, 2) = +sin(rotation[1]);
-    Ry(1, 1) = 1;
-    Ry(2, 0) = -sin(rotation[1]);
-    Ry(2, 2) = +cos(rotation[1]);
-
-    arma::Mat<double> Rz(3, 3, arma::fill::zeros);
-    Rz(0, 0) = +cos(rotation[2]);
-    Rz(0, 1) = -sin(rotation[2]);
-    Rz(1, 0) = +sin(rotation[2]);
-    Rz(1, 1) = +cos(rotation[2]);
-    Rz(2, 2) = 1;
+// rotation matrix Rz * Ry * Rx, i.e. rotation around x first,
+// then y, then z (extrinsic xyz Euler angles)
+static Matrix3 rotation_matrix(const std::array<double, 3>& rotation)
+{
+    double cx = cos(rotation[0]);
+    double sx = sin(rotation[0]);
+    double cy = cos(rotation[1]);
+    double sy = sin(rotation[1]);
+    double cz = cos(rotation[2]);
+    double sz = sin(rotation[2]);
+    Matrix3 m;
+    m[0] = {cz * cy, cz * sy * sx - sz * cx, cz * sy * cx + sz * sx};
+    m[1] = {sz * cy, sz * sy * sx + cz * cx, sz * sy * cx - cz * sx};
+    m[2] = {-sy, cy * sx, cy * cx};
+    return m;
+}
 
-    rotation_ = Rz * Ry * Rx;
+// row major (nb_points, 3) arrays. The coefficients are copied to
+// local variables so that the compiler does not reload them after
+// each write (transformed may alias points).
+static void apply_interleaved(const Matrix3& r,
+                              const std::array<double, 3>& t,
+                              const double* points,
+                              double* transformed,
+                              std::size_t nb_points)
+{
+    const double r00 = r[0][0], r01 = r[0][1], r02 = r[0][2];
+    const double r10 = r[1][0], r11 = r[1][1], r12 = r[1][2];
+    const double r20 = r[2][0], r21 = r[2][1], r22 = r[2][2];
+    const double t0 = t[0], t1 = t[1], t2 = t[2];
+    for (std::size_t i = 0; i < nb_points; i++)
+    {
+        const double x = points[3 * i];
+        const double y = points[3 * i + 1];
+        const double z = points[3 * i + 2];
+        transformed[3 * i] = r00 * x + r01 * y + r02 * z + t0;
+        transformed[3 * i + 1] = r10 * x + r11 * y + r12 * z + t1;
+        transformed[3 * i + 2] = r20 * x + r21 * y + r22 * z + t2;
+    }
 }
 
-namespace internal
+// structure of arrays: unit stride, no aliasing, one output array per
+// loop, i.e. the loops are vectorized by the compiler
+static void apply_soa(const Matrix3& r,
+                      const std::array<double, 3>& t,
+                      const double* __restrict x,
+                      const double* __restrict y,
+                      const double* __restrict z,
+                      double* __restrict transformed[3],
+                      std::size_t nb_points)
 {
-typedef std::tuple<std::array<double, 3>, std::array<double, 3>> TTuple;
+    for (std::size_t row = 0; row < 3; row++)
+    {
+        const double r0 = r[row][0];
+        const double r1 = r[row][1];
+        const double r2 = r[row][2];
+        const double tr = t[row];
+        double* __restrict out = transformed[row];
+        for (std::size_t i = 0; i < nb_points; i++)
+        {
+            out[i] = r0 * x[i] + r1 * y[i] + r2 * z[i] + tr;
+        }
+    }
+}
 
-class _Transform
+// calls f(start, size) over contiguous ranges of [0, nb_points),
+// each range in its own thread (the first one in the calling thread)
+template <class F>
+static void split(std::size_t nb_points, unsigned int nb_threads, F f)
 {
-public:
-    _Transform()
+    if (nb_threads == 0)
     {
+        std::size_t max_threads =
+            nb_points / TENNICAM_CLIENT_TRANSFORM_POINTS_PER_THREAD;
+        nb_threads = static_cast<unsigned int>(std::min<std::size_t>(
+            std::max(1u, std::thread::hardware_concurrency()), max_threads));
     }
-    _Transform(const std::array<double, 3>& _translation,
-               const std::array<double, 3>& _rotation)
-        : translation(_translation), rotation(_rotation)
+    if (nb_threads <= 1)
     {
+        f(0, nb_points);
+        return;
     }
-    std::array<double, 3> translation;
-    std::array<double, 3> rotation;
-    TTuple get()
+    // multiple of 8, so that ranges start on a cache line
+    std::size_t per_thread = (nb_points + nb_threads - 1) / nb_threads;
+    per_thread = ((per_thread + 7) / 8) * 8;
+    std::vector<std::thread> threads;
+    threads.reserve(nb_threads);
+    for (std::size_t start = per_thread; start < nb_points; start += per_thread)
     {
-        return TTuple(translation, rotation);
+        threads.emplace_back(f, start, std::min(per_thread, nb_points - start));
     }
-    template <class Archive>
-    void serialize(Archive& archive)
+    f(0, std::min(per_thread, nb_points));
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+}  // namespace internal
+
+Transform::Transform(std::array<double, 3> translation,
+                     std::array<double, 3> rotation)
+    : Transform(internal::rotation_matrix(rotation), translation)
+{
+}
+
+void Transform::apply(const double* points,
+                      double* transformed,
+                      std::size_t nb_points,
+                      unsigned int nb_threads) const
+{
+    internal::split(nb_points,
+                    nb_threads,
+                    [&](std::size_t start, std::size_t size)
+                    {
+                        internal::apply_interleaved(rotation_,
+                                                    translation_,
+                                                    points + 3 * start,
+                                                    transformed + 3 * start,
+                                                    size);
+                    });
+}
+
+void Transform::apply(const double* x,
+                      const double* y,
+                      const double* z,
+                      double* transformed_x,
+                      double* transformed_y,
+                      double* transformed_z,
+                      std::size_t nb_points,
+                      unsigned int nb_threads) const
+{
+    internal::split(nb_points,
+                    nb_threads,
+                    [&](std::size_t start, std::size_t size)
+                    {
+                        double* transformed[3] = {transformed_x + start,
+                                                  transformed_y + start,
+                                                  transformed_z + start};
+                        internal::apply_soa(rotation_,
+                                            translation_,
+                                            x + start,
+                                            y + start,
+                                            z + start,
+                                            transformed,
+                                            size);
+                    });
+}
+
+namespace internal
+{
+void TransformRecord::write(const std::array<double, 3>& translation,
+                            const std::array<double, 3>& rotation)
+{
+    values_.write({translation[0],
+                   translation[1],
+                   translation[2],
+                   rotation[0],
+                   rotation[1],
+                   rotation[2]});
+}
+
+std::uint64_t TransformRecord::read(std::array<double, 3>& translation,
+                                    std::array<double, 3>& rotation) const
+{
+    std::array<double, 6> values;
+    std::uint64_t version = values_.read(values);
+    for (std::size_t index = 0; index < 3; index++)
     {
-        archive(translation, rotation);
+        translation[index] = values[index];
+        rotation[index] = values[index + 3];
     }
-};
+    return version;
+}
+
 }  // namespace internal
 
-std::array<double, 3> Transform::apply(const std::array<double, 3>& v) const
+std::string transform_segment_id(const std::string& segment_id)
 {
-    for (std::size_t index = 0; index < 3; index++) tmp_[index] = v[index];
-    arma::vec transformed = rotation_ * tmp_ + translation_;
-    return std::array<double, 3>{
-        transformed[0], transformed[1], transformed[2]};
+    return segment_id + std::string("_transform");
 }
 
 std::tuple<std::array<double, 3>, std::array<double, 3>>
 read_transform_from_memory(std::string segment_id)
 {
-    internal::_Transform t;
-    shared_memory::deserialize(segment_id, "transform", t);
-    return t.get();
+    SharedRecord<internal::TransformRecord> record(
+        transform_segment_id(segment_id), SharedRecordMode::OPEN);
+    std::array<double, 3> translation;
+    std::array<double, 3> rotation;
+    record.get().read(translation, rotation);
+    return std::make_tuple(translation, rotation);
 }
 
 void write_transform_to_memory(std::string segment_id,
                                const std::array<double, 3>& translation,
                                const std::array<double, 3>& rotation)
 {
-    internal::_Transform t(translation, rotation);
-    shared_memory::serialize(segment_id, "transform", t);
+    SharedRecord<internal::TransformRecord> record(
+        transform_segment_id(segment_id), SharedRecordMode::OPEN_OR_CREATE);
+    record.get().write(translation, rotation);
 }
 
 }  // namespace tennicam_client
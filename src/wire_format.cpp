@@ -0,0 +1,97 @@
+#include "tennicam_client/wire_format.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace tennicam_client
+{
+WireFormat to_wire_format(const std::string& wire_format)
+{
+    if (wire_format == "json")
+    {
+        return WireFormat::JSON;
+    }
+    if (wire_format == "binary")
+    {
+        return WireFormat::BINARY;
+    }
+    throw std::invalid_argument(
+        std::string("unknown wire format: ") + wire_format +
+        std::string(" (expected 'json' or 'binary')"));
+}
+
+bool is_binary_frame(const char* data, std::size_t size)
+{
+    if (size < sizeof(std::uint32_t))
+    {
+        return false;
+    }
+    std::uint32_t magic;
+    std::memcpy(&magic, data, sizeof(std::uint32_t));
+    return magic == BINARY_FRAME_MAGIC;
+}
+
+std::size_t encode_binary_frame(const Frame& frame, char* buffer)
+{
+    BinaryFrameHeader header;
+    header.magic = BINARY_FRAME_MAGIC;
+    header.version = BINARY_FRAME_VERSION;
+    header.nb_detections = 0;
+    if (frame.detected)
+    {
+        header.nb_detections =
+            static_cast<std::uint16_t>(std::max<std::size_t>(
+                std::min<std::size_t>(frame.nb_detections,
+                                      TENNICAM_CLIENT_MAX_DETECTIONS),
+                1));
+    }
+    header.num = frame.num;
+    header.time_stamp = frame.time_stamp;
+    header.proc_time = frame.proc_time;
+    std::memcpy(buffer, &header, sizeof(BinaryFrameHeader));
+    char* detections = buffer + sizeof(BinaryFrameHeader);
+    if (frame.detected)
+    {
+        std::memcpy(detections, frame.position.data(), 3 * sizeof(double));
+    }
+    for (std::size_t index = 1; index < header.nb_detections; index++)
+    {
+        std::memcpy(detections + index * 3 * sizeof(double),
+                    frame.detections[index].data(),
+                    3 * sizeof(double));
+    }
+    return binary_frame_size(header.nb_detections);
+}
+
+bool decode_binary_frame(const char* data, std::size_t size, Frame& frame)
+{
+    if (size < sizeof(BinaryFrameHeader))
+    {
+        return false;
+    }
+    BinaryFrameHeader header;
+    std::memcpy(&header, data, sizeof(BinaryFrameHeader));
+    if (header.magic != BINARY_FRAME_MAGIC ||
+        header.version != BINARY_FRAME_VERSION ||
+        size < binary_frame_size(header.nb_detections))
+    {
+        return false;
+    }
+    frame.num = header.num;
+    frame.time_stamp = header.time_stamp;
+    frame.proc_time = header.proc_time;
+    frame.detected = header.nb_detections > 0;
+    frame.nb_detections = std::min<std::size_t>(
+        header.nb_detections, TENNICAM_CLIENT_MAX_DETECTIONS);
+    // the detections are contiguous (x, y, z of each ball)
+    std::memcpy(frame.detections.data(),
+                data + sizeof(BinaryFrameHeader),
+                frame.nb_detections * 3 * sizeof(double));
+    if (frame.detected)
+    {
+        frame.position = frame.detections[0];
+    }
+    return true;
+}
+
+}  // namespace tennicam_client
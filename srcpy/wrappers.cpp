@@ -1,8 +1,184 @@
+#include <pybind11/numpy.h>
+#include <algorithm>
+#include <stdexcept>
+#include "o80/front_end.hpp"
 #include "o80/pybind11_helper.hpp"
+#include "tennicam_client/ball_record.hpp"  // read_balls
+#include "tennicam_client/clock_sync.hpp"  // read_clock_offset
 #include "tennicam_client/driver_config.hpp"  // update_transform_config_file
+#include "tennicam_client/dummy_server.hpp"  // DummyServer
+#include "tennicam_client/frame_statistics.hpp"  // read_frame_statistics
+#include "tennicam_client/new_ball.hpp"          // BallWaiter
+#include "tennicam_client/predictor.hpp"         // read_prediction
 #include "tennicam_client/standalone.hpp"
+#include "tennicam_client/state_query.hpp"  // StateQuery
 #include "tennicam_client/transform.hpp"  // read/write_transform_from/to_memory
 
+// (N,3) arrays of double. Input arrays already C contiguous and of
+// type float64 are used without copy.
+typedef pybind11::array_t<double,
+                          pybind11::array::c_style |
+                              pybind11::array::forcecast>
+    PointsIn;
+typedef pybind11::array_t<double, pybind11::array::c_style> PointsOut;
+
+// structured numpy arrays of balls (see read_balls)
+PYBIND11_NUMPY_DTYPE(tennicam_client::BallRecord,
+                     ball_id,
+                     time_stamp,
+                     compensated_time_stamp,
+                     nb_skipped_frames,
+                     segment_id,
+                     position,
+                     velocity,
+                     events);
+typedef pybind11::array_t<tennicam_client::BallRecord,
+                          pybind11::array::c_style>
+    Balls;
+
+static std::size_t check_points(const pybind11::array& points,
+                                const std::string& name)
+{
+    if (points.ndim() != 2 || points.shape(1) != 3)
+    {
+        throw std::invalid_argument(name + " should be of shape (N,3)");
+    }
+    return static_cast<std::size_t>(points.shape(0));
+}
+
+void add_transform(pybind11::module& m)
+{
+    typedef tennicam_client::Transform tr;
+    pybind11::class_<tr>(m, "Transform")
+        .def(pybind11::init<std::array<double, 3>, std::array<double, 3>>(),
+             pybind11::arg("translation"),
+             pybind11::arg("rotation"))
+        .def("apply",
+             pybind11::overload_cast<const std::array<double, 3>&>(
+                 &tr::apply, pybind11::const_))
+        // transforms a (N,3) array of positions. The result is written
+        // in out (if provided, should be a writeable C contiguous (N,3)
+        // float64 array, possibly points itself), else in a new array.
+        .def(
+            "apply_batch",
+            [](const tr& t,
+               PointsIn points,
+               pybind11::object out,
+               unsigned int nb_threads)
+            {
+                std::size_t nb_points = check_points(points, "points");
+                // (casting any other array would silently write the
+                // result in a copy)
+                if (!out.is_none() && !pybind11::isinstance<PointsOut>(out))
+                {
+                    throw std::invalid_argument(
+                        "apply_batch: out should be a C contiguous float64 "
+                        "array");
+                }
+                PointsOut transformed =
+                    out.is_none()
+                        ? PointsOut({nb_points, std::size_t(3)})
+                        : out.cast<PointsOut>();
+                if (check_points(transformed, "out") != nb_points)
+                {
+                    throw std::invalid_argument(
+                        "out and points should have the same shape");
+                }
+                if (!transformed.writeable())
+                {
+                    throw std::invalid_argument(
+                        "apply_batch: out should be writeable");
+                }
+                const double* in = points.data();
+                double* o = transformed.mutable_data();
+                {
+                    pybind11::gil_scoped_release release;
+                    t.apply(in, o, nb_points, nb_threads);
+                }
+                return transformed;
+            },
+            pybind11::arg("points"),
+            pybind11::arg("out") = pybind11::none(),
+            pybind11::arg("nb_threads") = 0);
+}
+
+// read_balls(frontend, start, end=None, out=None): the balls of the
+// iterations [start, end) of the history (end: up to the latest
+// iteration) as a structured array (fields of BallRecord), written in
+// out if provided (C contiguous array of the same dtype, long enough;
+// the returned array is then a view of out). Throws an IndexError if
+// start has already been overwritten, or is overwritten during the
+// copy (the content of out is then undefined).
+template <int QUEUE_SIZE>
+void add_read_balls(pybind11::module& m)
+{
+    typedef o80::FrontEnd<QUEUE_SIZE,
+                          1,
+                          tennicam_client::Ball,
+                          o80::VoidExtendedState>
+        FrontEnd;
+    m.def(
+        "read_balls",
+        [](FrontEnd& frontend,
+           long int start,
+           pybind11::object end,
+           pybind11::object out)
+        {
+            const long int newest = frontend.latest().get_iteration();
+            long int stop = end.is_none() ? newest + 1 : end.cast<long int>();
+            stop = std::min(stop, newest + 1);
+            if (start < 0 || (newest >= 0 && start <= newest - QUEUE_SIZE))
+            {
+                throw std::out_of_range(
+                    "read_balls: iteration " + std::to_string(start) +
+                    " is no longer in the history");
+            }
+            const std::size_t nb_balls =
+                static_cast<std::size_t>(std::max(0L, stop - start));
+            if (!out.is_none() && !pybind11::isinstance<Balls>(out))
+            {
+                throw std::invalid_argument(
+                    "read_balls: out should be a C contiguous array "
+                    "with the dtype of the balls");
+            }
+            Balls balls = out.is_none() ? Balls(nb_balls) : out.cast<Balls>();
+            if (balls.ndim() != 1 ||
+                static_cast<std::size_t>(balls.shape(0)) < nb_balls)
+            {
+                throw std::invalid_argument(
+                    "read_balls: out should be a 1d array of at least " +
+                    std::to_string(nb_balls) + " balls");
+            }
+            tennicam_client::BallRecord* records = balls.mutable_data();
+            {
+                pybind11::gil_scoped_release release;
+                for (std::size_t index = 0; index < nb_balls; index++)
+                {
+                    records[index] =
+                        frontend.read(start + static_cast<long int>(index))
+                            .get_observed_states()
+                            .get(0)
+                            .to_record();
+                }
+            }
+            // the backend may have overwritten the oldest iterations
+            // while they were copied (the GIL being released)
+            if (nb_balls > 0 &&
+                start <= frontend.latest().get_iteration() - QUEUE_SIZE)
+            {
+                throw std::out_of_range(
+                    "read_balls: iteration " + std::to_string(start) +
+                    " has been overwritten while being read");
+            }
+            // (view of out if longer than needed)
+            return pybind11::object(balls[pybind11::slice(0, nb_balls, 1)]);
+        },
+        pybind11::arg("frontend"),
+        pybind11::arg("start"),
+        pybind11::arg("end") = pybind11::none(),
+        pybind11::arg("out") = pybind11::none());
+}
+
 void add_tennicam_client(pybind11::module& m)
 {
     m.def("update_transform_config_file",
@@ -11,6 +187,180 @@ void add_tennicam_client(pybind11::module& m)
           &tennicam_client::read_transform_from_memory);
     m.def("write_transform_to_memory",
           &tennicam_client::write_transform_to_memory);
+
+    add_transform(m);
+
+    typedef tennicam_client::FrameStatistics fs;
+    pybind11::class_<fs>(m, "FrameStatistics")
+        .def(pybind11::init<>())
+        .def_readonly("nb_frames", &fs::nb_frames)
+        .def_readonly("last_num", &fs::last_num)
+        .def_readonly("nb_lost_frames", &fs::nb_lost_frames)
+        .def_readonly("nb_gaps", &fs::nb_gaps)
+        .def_readonly("nb_duplicates", &fs::nb_duplicates)
+        .def_readonly("nb_reordered", &fs::nb_reordered)
+        .def_readonly("nb_skipped_frames", &fs::nb_skipped_frames)
+        .def_readonly("nb_stalls", &fs::nb_stalls)
+        .def_readonly("nb_dropped", &fs::nb_dropped)
+        .def_readonly("nb_outliers", &fs::nb_outliers)
+        .def("__str__", &fs::to_string);
+    m.def("read_frame_statistics", &tennicam_client::read_frame_statistics);
+    // (opens the shared memory segment once, to be preferred
+    // over read_frame_statistics when called in a loop)
+    typedef tennicam_client::FrameStatisticsReader fsr;
+    pybind11::class_<fsr>(m, "FrameStatisticsReader")
+        .def(pybind11::init<std::string>(), pybind11::arg("segment_id"))
+        .def("get", &fsr::get);
+
+    typedef tennicam_client::Prediction pr;
+    pybind11::class_<pr>(m, "Prediction")
+        .def(pybind11::init<>())
+        .def_readonly("ball_id", &pr::ball_id)
+        .def_readonly("time_stamp", &pr::time_stamp)
+        .def_readonly("dt", &pr::dt)
+        .def_readonly("nb_steps", &pr::nb_steps)
+        // only the nb_steps first states are meaningful
+        .def_property_readonly(
+            "positions",
+            [](const pr& p)
+            {
+                return std::vector<std::array<double, 3>>(
+                    p.positions.begin(), p.positions.begin() + p.nb_steps);
+            })
+        .def_property_readonly(
+            "velocities",
+            [](const pr& p)
+            {
+                return std::vector<std::array<double, 3>>(
+                    p.velocities.begin(), p.velocities.begin() + p.nb_steps);
+            })
+        .def_readonly("crosses_plane", &pr::crosses_plane)
+        .def_readonly("plane_time", &pr::plane_time)
+        .def_readonly("plane_position", &pr::plane_position)
+        .def_readonly("plane_velocity", &pr::plane_velocity)
+        .def("__str__", &pr::to_string);
+    m.def("read_prediction", &tennicam_client::read_prediction);
+    typedef tennicam_client::PredictionReader prr;
+    pybind11::class_<prr>(m, "PredictionReader")
+        .def(pybind11::init<std::string>(), pybind11::arg("segment_id"))
+        .def("get", &prr::get);
+
+    typedef tennicam_client::ClockOffset co;
+    pybind11::class_<co>(m, "ClockOffset")
+        .def(pybind11::init<>())
+        .def_readonly("synchronized", &co::synchronized)
+        .def_readonly("offset_ns", &co::offset_ns)
+        .def_readonly("drift", &co::drift)
+        .def_readonly("reference_time_stamp", &co::reference_time_stamp)
+        .def_readonly("nb_windows", &co::nb_windows)
+        .def_readonly("nb_resets", &co::nb_resets)
+        .def("to_local", &co::to_local)
+        .def("__str__", &co::to_string);
+    m.def("read_clock_offset", &tennicam_client::read_clock_offset);
+    typedef tennicam_client::ClockOffsetReader cor;
+    pybind11::class_<cor>(m, "ClockOffsetReader")
+        .def(pybind11::init<std::string>(), pybind11::arg("segment_id"))
+        .def("get", &cor::get);
+
+    // length of the o80 history of a running standalone, and as
+    // configured in a toml file (see start_standalone in __init__.py)
+    m.def("read_history_size", &tennicam_client::read_history_size);
+    m.def("parse_history_size",
+          [](std::string toml_config_file)
+          {
+              return tennicam_client::parse_toml(toml_config_file)
+                  .history_size;
+          });
+
+    // standalone writing balls only when new ones are produced
+    // (see start_standalone in __init__.py)
+    m.def("parse_publish_on_change",
+          [](std::string toml_config_file)
+          {
+              return tennicam_client::parse_toml(toml_config_file)
+                  .publish_on_change;
+          });
+    m.def("start_publish_on_change_standalone",
+          &tennicam_client::start_publish_on_change_standalone);
+    m.def("stop_publish_on_change_standalone",
+          &tennicam_client::stop_publish_on_change_standalone);
+    m.def("is_publish_on_change_standalone_running",
+          &tennicam_client::is_publish_on_change_standalone_running);
+
+    // publishes balls (see DummyServer::trajectory) on the hostname and
+    // port configured in a toml file, e.g. for testing
+    typedef tennicam_client::DummyServer ds;
+    pybind11::class_<ds>(m, "DummyServer")
+        .def(pybind11::init(
+                 [](std::string toml_config_file,
+                    std::string wire_format,
+                    double frequency)
+                 {
+                     return std::make_unique<ds>(
+                         tennicam_client::parse_toml(toml_config_file),
+                         tennicam_client::to_wire_format(wire_format),
+                         frequency);
+                 }),
+             pybind11::arg("toml_config_file"),
+             pybind11::arg("wire_format") = "json",
+             pybind11::arg("frequency") = 100.)
+        .def("start", &ds::start)
+        .def("stop", &ds::stop)
+        .def_static("trajectory", &ds::trajectory);
+
+    typedef tennicam_client::BallWaiter bw;
+    pybind11::class_<bw>(m, "BallWaiter")
+        .def(pybind11::init<std::string>(), pybind11::arg("segment_id"))
+        // returns the new ball as a record of dtype ball_dtype (see
+        // read_balls), or None if no new ball within timeout_us (the
+        // GIL is released while waiting)
+        .def(
+            "wait",
+            [](bw& waiter, long int timeout_us) -> pybind11::object
+            {
+                tennicam_client::Ball ball;
+                bool received;
+                {
+                    pybind11::gil_scoped_release release;
+                    received = waiter.wait(timeout_us, ball);
+                }
+                if (!received)
+                {
+                    return pybind11::none();
+                }
+                Balls balls(1);
+                balls.mutable_data()[0] = ball.to_record();
+                return balls[pybind11::int_(0)];
+            },
+            pybind11::arg("timeout_us"));
+
+    typedef tennicam_client::BallState bs;
+    pybind11::class_<bs>(m, "BallState")
+        .def(pybind11::init<>())
+        .def_readonly("ball_id", &bs::ball_id)
+        .def_readonly("time_stamp", &bs::time_stamp)
+        .def_readonly("observation_time_stamp", &bs::observation_time_stamp)
+        .def_readonly("position", &bs::position)
+        .def_readonly("velocity", &bs::velocity)
+        .def_readonly("extrapolated", &bs::extrapolated)
+        .def("__str__", &bs::to_string);
+
+    typedef tennicam_client::StateQuery sq;
+    pybind11::class_<sq>(m, "StateQuery")
+        .def(pybind11::init<std::string, double>(),
+             pybind11::arg("segment_id"),
+             pybind11::arg("gravity") = 9.81)
+        // returns None if no ball was observed before time_stamp
+        .def("get",
+             [](sq& query, long int time_stamp) -> pybind11::object
+             {
+                 bs state;
+                 if (!query.get(time_stamp, state))
+                 {
+                     return pybind11::none();
+                 }
+                 return pybind11::cast(state);
+             });
 }
 
 void add_observation(pybind11::module& m)
@@ -34,15 +384,41 @@ void add_observation(pybind11::module& m)
         .def("get_time_stamp",
              [](observation& obs)
              { return obs.get_observed_states().get(0).get_time_stamp(); })
+        .def("get_compensated_time_stamp",
+             [](observation& obs)
+             {
+                 return obs.get_observed_states()
+                     .get(0)
+                     .get_compensated_time_stamp();
+             })
         .def("get_ball_id",
              [](observation& obs)
-             { return obs.get_observed_states().get(0).get_ball_id(); });
+             { return obs.get_observed_states().get(0).get_ball_id(); })
+        .def("get_nb_skipped_frames",
+             [](observation& obs) {
+                 return obs.get_observed_states()
+                     .get(0)
+                     .get_nb_skipped_frames();
+             })
+        .def("get_segment_id",
+             [](observation& obs)
+             { return obs.get_observed_states().get(0).get_segment_id(); })
+        .def("get_events",
+             [](observation& obs)
+             { return obs.get_observed_states().get(0).get_events(); });
+
+    // flags of get_events
+    m.attr("SEGMENT_START") = static_cast<int>(tennicam_client::SEGMENT_START);
+    m.attr("BOUNCE") = static_cast<int>(tennicam_client::BOUNCE);
+    m.attr("HIT") = static_cast<int>(tennicam_client::HIT);
+    m.attr("OUTLIER") = static_cast<int>(tennicam_client::OUTLIER);
 }
 
 PYBIND11_MODULE(tennicam_client_wrp, m)
 {
-    // adding update_transform_config_file, read_transform_from_memory
-    // and write transform to memory
+    // adding update_transform_config_file, read_transform_from_memory,
+    // write transform to memory, Transform, read_frame_statistics
+    // read_prediction, read_clock_offset and StateQuery
     add_tennicam_client(m);
     o80::create_python_bindings<tennicam_client::Standalone,
                                 o80::NO_OBSERVATION>(m);
@@ -56,4 +432,58 @@ PYBIND11_MODULE(tennicam_client_wrp, m)
         std::string,  // argument for the driver (path to toml file)
         std::string>  // argument for the driver (active transform)
         (m);
+    // other lengths of history, API prefixed with "History1k" /
+    // "history_1k_" (and 10k, 500k). Observation, state and extended
+    // state are the same as for the default standalone, so not bound
+    // again.
+    o80::create_python_bindings<tennicam_client::Standalone1k,
+                                o80::NO_OBSERVATION,
+                                o80::NO_STATE,
+                                o80::NO_EXTENDED_STATE>(
+        m, std::string("History1k"));
+    o80::create_standalone_python_bindings<tennicam_client::Driver,
+                                           tennicam_client::Standalone1k,
+                                           std::string,
+                                           std::string>(
+        m, std::string("history_1k_"));
+    o80::create_python_bindings<tennicam_client::Standalone10k,
+                                o80::NO_OBSERVATION,
+                                o80::NO_STATE,
+                                o80::NO_EXTENDED_STATE>(
+        m, std::string("History10k"));
+    o80::create_standalone_python_bindings<tennicam_client::Driver,
+                                           tennicam_client::Standalone10k,
+                                           std::string,
+                                           std::string>(
+        m, std::string("history_10k_"));
+    o80::create_python_bindings<tennicam_client::Standalone500k,
+                                o80::NO_OBSERVATION,
+                                o80::NO_STATE,
+                                o80::NO_EXTENDED_STATE>(
+        m, std::string("History500k"));
+    o80::create_standalone_python_bindings<tennicam_client::Driver,
+                                           tennicam_client::Standalone500k,
+                                           std::string,
+                                           std::string>(
+        m, std::string("history_500k_"));
+    // batched reads of the history, for all lengths of history (the
+    // dtype of the returned arrays being ball_dtype)
+    m.attr("ball_dtype") = pybind11::dtype::of<tennicam_client::BallRecord>();
+    add_read_balls<TENNICAM_CLIENT_HISTORY_SIZE_1K>(m);
+    add_read_balls<TENNICAM_CLIENT_HISTORY_SIZE_10K>(m);
+    add_read_balls<TENNICAM_CLIENT_HISTORY_SIZE_50K>(m);
+    add_read_balls<TENNICAM_CLIENT_HISTORY_SIZE_500K>(m);
+    // multiple balls (one dof per track), API prefixed with
+    // "MultiBall" / "multi_ball_". State and extended state are the
+    // same as for the single ball standalone, so not bound again.
+    o80::create_python_bindings<tennicam_client::MultiBallStandalone,
+                                o80::NO_STATE,
+                                o80::NO_EXTENDED_STATE>(
+        m, std::string("MultiBall"));
+    o80::create_standalone_python_bindings<
+        tennicam_client::MultiBallDriver,
+        tennicam_client::MultiBallStandalone,
+        std::string,  // argument for the driver (path to toml file)
+        std::string>  // argument for the driver (active transform)
+        (m, std::string("multi_ball_"));
 }
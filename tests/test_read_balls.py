@@ -0,0 +1,132 @@
+import time
+import numpy as np
+import pytest
+import tennicam_client
+
+_SEGMENT_ID = "tennicam_client_test_read_balls"
+_HISTORY_SIZE = 1000
+
+
+def _wait_iteration(frontend, iteration, timeout=10.0):
+    start = time.time()
+    while frontend.latest().get_iteration() < iteration:
+        assert time.time() - start < timeout
+        time.sleep(0.01)
+
+
+@pytest.fixture(scope="module")
+def frontend(tmp_path_factory):
+    # standalone at 1kHz receiving balls from a dummy server at 500Hz
+    config = tmp_path_factory.mktemp("config") / "config.toml"
+    config.write_text(
+        "[transform]\n"
+        "translation = [0,0,0]\n"
+        "rotation = [0,0,0]\n"
+        "[server]\n"
+        'hostname = "127.0.0.1"\n'
+        "port = 7676\n"
+        "[driver]\n"
+        "history_size = {}\n".format(_HISTORY_SIZE)
+    )
+    server = tennicam_client.DummyServer(str(config), "binary", 500.0)
+    server.start()
+    tennicam_client.start_standalone(
+        _SEGMENT_ID, 1000.0, False, str(config), "", _HISTORY_SIZE, False
+    )
+    frontend = tennicam_client.get_frontend(_SEGMENT_ID)
+    # the history already wrapped around
+    _wait_iteration(frontend, 2 * _HISTORY_SIZE)
+    yield frontend
+    tennicam_client.stop_standalone(_SEGMENT_ID)
+    server.stop()
+
+
+def _recent_range(frontend, length):
+    # iterations far enough from the oldest one not to be overwritten
+    # during the test
+    newest = frontend.latest().get_iteration()
+    return newest - length, newest
+
+
+def test_read_balls_dtype(frontend):
+    start, end = _recent_range(frontend, 10)
+    balls = tennicam_client.read_balls(frontend, start, end)
+    assert balls.dtype == tennicam_client.ball_dtype
+    assert set(balls.dtype.names) == {
+        "ball_id",
+        "time_stamp",
+        "compensated_time_stamp",
+        "nb_skipped_frames",
+        "segment_id",
+        "position",
+        "velocity",
+        "events",
+    }
+    assert balls["position"].shape == (10, 3)
+    assert balls["velocity"].shape == (10, 3)
+
+
+def test_read_balls_range(frontend):
+    start, end = _recent_range(frontend, 100)
+    balls = tennicam_client.read_balls(frontend, start, end)
+    # [start, end)
+    assert len(balls) == end - start
+    for index, ball in enumerate(balls):
+        observation = frontend.read(start + index)
+        assert ball["ball_id"] == observation.get_ball_id()
+        assert ball["time_stamp"] == observation.get_time_stamp()
+        assert (
+            ball["compensated_time_stamp"]
+            == observation.get_compensated_time_stamp()
+        )
+        assert ball["nb_skipped_frames"] == observation.get_nb_skipped_frames()
+        assert ball["segment_id"] == observation.get_segment_id()
+        assert ball["events"] == observation.get_events()
+        np.testing.assert_array_equal(ball["position"], observation.get_position())
+        np.testing.assert_array_equal(ball["velocity"], observation.get_velocity())
+    assert (balls["ball_id"] >= 0).any()
+
+
+def test_read_balls_end_default(frontend):
+    start, newest = _recent_range(frontend, 10)
+    balls = tennicam_client.read_balls(frontend, start)
+    # up to the latest iteration (the standalone is running)
+    assert len(balls) >= newest - start + 1
+    assert len(balls) <= _HISTORY_SIZE
+    assert balls[0]["time_stamp"] == frontend.read(start).get_time_stamp()
+    # end after the latest iteration
+    balls = tennicam_client.read_balls(frontend, start, newest + 10**6)
+    assert len(balls) >= newest - start + 1
+    # empty range
+    assert len(tennicam_client.read_balls(frontend, start, start)) == 0
+
+
+def test_read_balls_out(frontend):
+    out = np.zeros(100, dtype=tennicam_client.ball_dtype)
+    for _ in range(2):
+        start, end = _recent_range(frontend, 50)
+        balls = tennicam_client.read_balls(frontend, start, end, out=out)
+        assert len(balls) == 50
+        assert np.shares_memory(balls, out)
+        np.testing.assert_array_equal(balls, out[:50])
+        assert out[0]["time_stamp"] == frontend.read(start).get_time_stamp()
+
+
+def test_read_balls_overwritten(frontend):
+    newest = frontend.latest().get_iteration()
+    with pytest.raises(IndexError):
+        tennicam_client.read_balls(frontend, newest - 2 * _HISTORY_SIZE)
+    with pytest.raises(IndexError):
+        tennicam_client.read_balls(frontend, -1)
+
+
+def test_read_balls_invalid_out(frontend):
+    start, end = _recent_range(frontend, 50)
+    wrong_dtype = np.zeros(100)
+    too_short = np.zeros(10, dtype=tennicam_client.ball_dtype)
+    two_dimensional = np.zeros((50, 2), dtype=tennicam_client.ball_dtype)
+    for out in (wrong_dtype, too_short, two_dimensional):
+        with pytest.raises(ValueError):
+            tennicam_client.read_balls(frontend, start, end, out=out)
+        # (structured arrays do not support any)
+        assert not any(out.tobytes())
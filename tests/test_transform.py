@@ -0,0 +1,33 @@
+import numpy as np
+import pytest
+import tennicam_client
+
+
+def _transform():
+    return tennicam_client.Transform([0.1, 0.2, 0.3], [0.0, 0.5, 1.0])
+
+
+def test_apply_batch_out():
+    transform = _transform()
+    points = np.random.default_rng(0).random((100, 3))
+    expected = np.array([transform.apply(list(p)) for p in points])
+    out = np.zeros((100, 3))
+    returned = transform.apply_batch(points, out=out)
+    np.testing.assert_allclose(out, expected)
+    assert np.shares_memory(returned, out)
+
+
+def test_apply_batch_invalid_out():
+    # out arrays the result can not be written in directly should be
+    # rejected (rather than the result being written in a copy)
+    transform = _transform()
+    points = np.random.default_rng(0).random((100, 3))
+    transposed = np.zeros((3, 100)).T
+    sliced = np.zeros((200, 3))[::2]
+    float32 = np.zeros((100, 3), dtype=np.float32)
+    read_only = np.zeros((100, 3))
+    read_only.flags.writeable = False
+    for out in (transposed, sliced, float32, read_only):
+        with pytest.raises(ValueError):
+            transform.apply_batch(points, out=out)
+        assert not out.any()
@@ -1,8 +1,31 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <filesystem>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
 #include "gtest/gtest.h"
+#include "o80/front_end.hpp"
 #include "tennicam_client/ball.hpp"
+#include "tennicam_client/clock_sync.hpp"
 #include "tennicam_client/driver.hpp"
+#include "tennicam_client/dummy_server.hpp"
+#include "tennicam_client/estimator.hpp"
+#include "tennicam_client/frame_parser.hpp"
+#include "tennicam_client/frame_statistics.hpp"
+#include "tennicam_client/new_ball.hpp"
+#include "tennicam_client/outlier_gate.hpp"
+#include "tennicam_client/predictor.hpp"
+#include "tennicam_client/resampler.hpp"
+#include "tennicam_client/segmenter.hpp"
+#include "tennicam_client/spsc_queue.hpp"
+#include "tennicam_client/standalone.hpp"
+#include "tennicam_client/state_query.hpp"
+#include "tennicam_client/tracker.hpp"
 #include "tennicam_client/transform.hpp"
+#include "tennicam_client/wire_format.hpp"
 
 using namespace tennicam_client;
 
@@ -24,6 +47,8 @@ TEST_F(TennicamClientTests, ball_serialization)
     long int time_stamp = 100;
 
     Ball in{ball_id, position, velocity, time_stamp};
+    in.set_nb_skipped_frames(2);
+    in.set_segment(7, SEGMENT_START | BOUNCE);
     shared_memory::serialize(segment_id, segment_id, in);
 
     Ball out;
@@ -31,6 +56,9 @@ TEST_F(TennicamClientTests, ball_serialization)
 
     ASSERT_EQ(ball_id, out.get_ball_id());
     ASSERT_EQ(time_stamp, out.get_time_stamp());
+    ASSERT_EQ(2, out.get_nb_skipped_frames());
+    ASSERT_EQ(7, out.get_segment_id());
+    ASSERT_EQ(SEGMENT_START | BOUNCE, out.get_events());
 
     for (std::size_t index = 0; index < 3; index++)
     {
@@ -41,6 +69,33 @@ TEST_F(TennicamClientTests, ball_serialization)
     shared_memory::clear_shared_memory(segment_id);
 }
 
+TEST_F(TennicamClientTests, ball_record)
+{
+    Ball in{5, {0.1234567891, -2.5, 1.}, {4., 5., -6.}, 100};
+    in.set_compensated_time_stamp(150);
+    in.set_nb_skipped_frames(2);
+    in.set_segment(7, SEGMENT_START | HIT);
+
+    BallRecord record = in.to_record();
+    char buffer[sizeof(BallRecord)];
+    std::memcpy(buffer, &record, sizeof(BallRecord));
+    BallRecord copy;
+    std::memcpy(&copy, buffer, sizeof(BallRecord));
+    Ball out(copy);
+
+    ASSERT_EQ(5, out.get_ball_id());
+    ASSERT_EQ(100, out.get_time_stamp());
+    ASSERT_EQ(150, out.get_compensated_time_stamp());
+    ASSERT_EQ(2, out.get_nb_skipped_frames());
+    ASSERT_EQ(7, out.get_segment_id());
+    ASSERT_EQ(SEGMENT_START | HIT, out.get_events());
+    for (std::size_t index = 0; index < 3; index++)
+    {
+        ASSERT_EQ(in.get_position()[index], out.get_position()[index]);
+        ASSERT_EQ(in.get_velocity()[index], out.get_velocity()[index]);
+    }
+}
+
 TEST_F(TennicamClientTests, identity_transform)
 {
     std::array<double, 3> translation;
@@ -113,6 +168,91 @@ TEST_F(TennicamClientTests, axis_rotation)
     ASSERT_DOUBLE_EQ(out_z[2], 0);
 }
 
+TEST_F(TennicamClientTests, combined_rotation)
+{
+    // the combined rotation matrix should be equivalent to
+    // rotating successively around x, y and z
+    std::array<double, 3> zero{0, 0, 0};
+    std::array<double, 3> translation{0.5, -1.2, 2.};
+    std::array<double, 3> rotation{0.3, -1.1, 2.4};
+    Transform t_x{zero, {rotation[0], 0, 0}};
+    Transform t_y{zero, {0, rotation[1], 0}};
+    Transform t_z{zero, {0, 0, rotation[2]}};
+    Transform t{translation, rotation};
+    std::array<double, 3> in{0.7, 1.3, -0.4};
+    std::array<double, 3> expected = t_z.apply(t_y.apply(t_x.apply(in)));
+    std::array<double, 3> out = t.apply(in);
+    for (std::size_t index = 0; index < 3; index++)
+    {
+        ASSERT_NEAR(out[index], expected[index] + translation[index], 1e-12);
+    }
+
+    // transforms built from a matrix can be used at compile time
+    constexpr Matrix3 swap_xy{{{0, 1, 0}, {1, 0, 0}, {0, 0, 1}}};
+    constexpr Transform t_swap{swap_xy, {1, 2, 3}};
+    constexpr std::array<double, 3> swapped = t_swap.apply({4, 5, 6});
+    static_assert(swapped[0] == 6 && swapped[1] == 6 && swapped[2] == 9);
+}
+
+TEST_F(TennicamClientTests, batch_transform)
+{
+    std::array<double, 3> translation{0.5, -1.2, 2.};
+    std::array<double, 3> rotation{0.3, -1.1, 2.4};
+    Transform t{translation, rotation};
+    // large enough to be split over several threads
+    std::size_t nb_points = 3 * TENNICAM_CLIENT_TRANSFORM_POINTS_PER_THREAD + 7;
+    std::vector<double> points(3 * nb_points);
+    for (std::size_t index = 0; index < points.size(); index++)
+    {
+        points[index] = sin(static_cast<double>(index));
+    }
+    for (unsigned int nb_threads : {1u, 3u, 0u})
+    {
+        std::vector<double> transformed(3 * nb_points);
+        t.apply(points.data(), transformed.data(), nb_points, nb_threads);
+        for (std::size_t p = 0; p < nb_points; p++)
+        {
+            std::array<double, 3> expected =
+                t.apply({points[3 * p], points[3 * p + 1], points[3 * p + 2]});
+            for (std::size_t dim = 0; dim < 3; dim++)
+            {
+                ASSERT_NEAR(
+                    transformed[3 * p + dim], expected[dim], 1e-12);
+            }
+        }
+    }
+    // structure of arrays
+    std::vector<double> expected(3 * nb_points);
+    t.apply(points.data(), expected.data(), nb_points);
+    std::vector<std::vector<double>> soa(3, std::vector<double>(nb_points));
+    std::vector<std::vector<double>> out(3, std::vector<double>(nb_points));
+    for (std::size_t p = 0; p < nb_points; p++)
+    {
+        for (std::size_t dim = 0; dim < 3; dim++)
+        {
+            soa[dim][p] = points[3 * p + dim];
+        }
+    }
+    t.apply(soa[0].data(),
+            soa[1].data(),
+            soa[2].data(),
+            out[0].data(),
+            out[1].data(),
+            out[2].data(),
+            nb_points,
+            2);
+    for (std::size_t p = 0; p < nb_points; p++)
+    {
+        for (std::size_t dim = 0; dim < 3; dim++)
+        {
+            ASSERT_NEAR(out[dim][p], expected[3 * p + dim], 1e-12);
+        }
+    }
+    // in place
+    t.apply(points.data(), points.data(), nb_points, 2);
+    ASSERT_EQ(points, expected);
+}
+
 TEST_F(TennicamClientTests, parse_toml)
 {
     // writting tmp config file
@@ -144,7 +284,8 @@ TEST_F(TennicamClientTests, parse_toml)
 TEST_F(TennicamClientTests, read_write_transform)
 {
     const std::string segment_id = "tennicam_client_tests";
-    shared_memory::clear_shared_memory(segment_id);
+    SharedRecord<internal::TransformRecord>::clear(
+        transform_segment_id(segment_id));
 
     // writting tmp config file
     std::filesystem::path tmp_file = std::filesystem::temp_directory_path();
@@ -195,3 +336,1283 @@ TEST_F(TennicamClientTests, read_write_transform)
     ASSERT_STREQ(std::string("127.0.0.1").c_str(),
                  config.server_hostname.c_str());
 }
+
+TEST_F(TennicamClientTests, transform_record)
+{
+    internal::TransformRecord record;
+    std::array<double, 3> translation;
+    std::array<double, 3> rotation;
+    ASSERT_EQ(record.get_version(), 0);
+    record.write({1, 2, 3}, {4, 5, 6});
+    ASSERT_EQ(record.get_version(), 2);
+    ASSERT_EQ(record.read(translation, rotation), 2);
+    ASSERT_DOUBLE_EQ(translation[2], 3);
+    ASSERT_DOUBLE_EQ(rotation[0], 4);
+
+    // concurrent writes: readers never see a partially written transform
+    record.write({0, 0, 0}, {0, 0, 0});
+    constexpr int nb_writes = 20000;
+    std::thread writer(
+        [&record]()
+        {
+            for (int index = 1; index <= nb_writes; index++)
+            {
+                double v = static_cast<double>(index);
+                record.write({v, v, v}, {v, v, v});
+            }
+        });
+    std::uint64_t version = 0;
+    bool consistent = true;
+    while (version < 4 + 2 * nb_writes)
+    {
+        version = record.read(translation, rotation);
+        for (std::size_t index = 0; index < 3; index++)
+        {
+            consistent = consistent && translation[index] == translation[0] &&
+                         rotation[index] == translation[0];
+        }
+        std::this_thread::yield();
+    }
+    writer.join();
+    ASSERT_TRUE(consistent);
+}
+
+TEST_F(TennicamClientTests, parse_toml_receive_mode)
+{
+    std::filesystem::path tmp_file = std::filesystem::temp_directory_path();
+    tmp_file /= "tennicam_client_tests_tmp";
+    std::ofstream os;
+    os.open(tmp_file.c_str());
+    os << "[transform]" << std::endl
+       << "translation = [0,1,2]" << std::endl
+       << "rotation = [0.0,0.1,0.2]" << std::endl
+       << "[server]" << std::endl
+       << "hostname = \"127.0.0.1\"" << std::endl
+       << "port = 7660" << std::endl
+       << "receive_mode = \"poll\"" << std::endl
+       << "receive_timeout_ms = 20" << std::endl
+       << "receive_spin_us = 50" << std::endl;
+    os.close();
+
+    DriverConfig config = parse_toml(tmp_file.string());
+    ASSERT_TRUE(config.receive_mode == ReceiveMode::POLL);
+    ASSERT_EQ(config.receive_timeout_ms, 20);
+    ASSERT_EQ(config.receive_spin_us, 50);
+
+    // updating the transform should not erase the other entries
+    std::array<double, 3> translation{3, 4, 5};
+    std::array<double, 3> rotation{0.3, 0.4, 0.5};
+    update_transform_config_file(tmp_file.string(), translation, rotation);
+    config = parse_toml(tmp_file.string());
+    ASSERT_TRUE(config.receive_mode == ReceiveMode::POLL);
+    ASSERT_EQ(config.receive_timeout_ms, 20);
+    ASSERT_EQ(config.receive_spin_us, 50);
+    for (std::size_t index = 0; index < 3; index++)
+    {
+        ASSERT_DOUBLE_EQ(config.translation[index], translation[index]);
+        ASSERT_DOUBLE_EQ(config.rotation[index], rotation[index]);
+    }
+
+    // default values
+    os.open(tmp_file.c_str());
+    os << "[transform]" << std::endl
+       << "translation = [0,1,2]" << std::endl
+       << "rotation = [0.0,0.1,0.2]" << std::endl
+       << "[server]" << std::endl
+       << "hostname = \"127.0.0.1\"" << std::endl
+       << "port = 7660" << std::endl;
+    os.close();
+    config = parse_toml(tmp_file.string());
+    ASSERT_TRUE(config.receive_mode == ReceiveMode::SPIN);
+}
+
+TEST_F(TennicamClientTests, parse_toml_history_size)
+{
+    std::filesystem::path tmp_file = std::filesystem::temp_directory_path();
+    tmp_file /= "tennicam_client_tests_tmp";
+    auto write = [&](const std::string& driver)
+    {
+        std::ofstream os;
+        os.open(tmp_file.c_str());
+        os << "[transform]" << std::endl
+           << "translation = [0,1,2]" << std::endl
+           << "rotation = [0.0,0.1,0.2]" << std::endl
+           << "[server]" << std::endl
+           << "hostname = \"127.0.0.1\"" << std::endl
+           << "port = 7660" << std::endl
+           << "[driver]" << std::endl
+           << driver << std::endl;
+        os.close();
+    };
+
+    write("");
+    ASSERT_EQ(parse_toml(tmp_file.string()).history_size, 50000);
+    write("history_size = 1000");
+    ASSERT_EQ(parse_toml(tmp_file.string()).history_size, 1000);
+    write("history_size = 500000");
+    ASSERT_EQ(parse_toml(tmp_file.string()).history_size, 500000);
+    write("history_size = 1234");
+    ASSERT_THROW(parse_toml(tmp_file.string()), std::invalid_argument);
+}
+
+TEST_F(TennicamClientTests, estimators)
+{
+    // ballistic trajectory observed at 200Hz, with a noise of 2mm
+    std::mt19937 generator(0);
+    std::normal_distribution<double> noise(0., 0.002);
+    constexpr double g = 9.81;
+    FiniteDifference finite_difference;
+    KalmanFilter kalman(0.002, 1000., g);
+    double fd_error = 0;
+    double kalman_error = 0;
+    for (int index = 0; index < 200; index++)
+    {
+        double t = 0.005 * index;
+        long int time_stamp = static_cast<long int>(index) * 5000000;
+        std::array<double, 3> position{0.5 * t + noise(generator),
+                                       -2. * t + noise(generator),
+                                       4. * t - 0.5 * g * t * t +
+                                           noise(generator)};
+        std::array<double, 3> velocity{0.5, -2., 4. - g * t};
+        std::array<double, 3> fd_v =
+            finite_difference.update(time_stamp, position);
+        std::array<double, 3> kalman_v = kalman.update(time_stamp, position);
+        if (index >= 50)
+        {
+            for (std::size_t dim = 0; dim < 3; dim++)
+            {
+                fd_error += std::abs(fd_v[dim] - velocity[dim]);
+                kalman_error += std::abs(kalman_v[dim] - velocity[dim]);
+            }
+        }
+    }
+    ASSERT_LT(kalman_error, fd_error / 4.);
+    ASSERT_LT(kalman_error / (150 * 3), 0.2);
+
+    // duplicated time stamp: no division by zero
+    std::array<double, 3> v = finite_difference.update(
+        static_cast<long int>(199) * 5000000, {0, 0, 0});
+    ASSERT_TRUE(std::isfinite(v[0]));
+    v = kalman.update(static_cast<long int>(199) * 5000000, {0, 0, 0});
+    ASSERT_TRUE(std::isfinite(v[0]));
+
+    // reset: zero velocity until a second observation
+    kalman.reset();
+    v = kalman.update(0, {1, 1, 1});
+    ASSERT_DOUBLE_EQ(v[0], 0.);
+
+    DriverConfig config;
+    ASSERT_TRUE(dynamic_cast<FiniteDifference*>(
+                    create_estimator(config).get()) != nullptr);
+    config.estimator = to_estimator_type("kalman");
+    ASSERT_TRUE(dynamic_cast<KalmanFilter*>(create_estimator(config).get()) !=
+                nullptr);
+    ASSERT_THROW(to_estimator_type("unknown"), std::invalid_argument);
+}
+
+TEST_F(TennicamClientTests, polynomial_fit)
+{
+    // exact for a quadratic trajectory, including with non equally
+    // spaced time stamps and after the sums have been rebased
+    PolynomialFit fit(8, 2);
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<long int> jitter(-1000000, 1000000);
+    std::array<double, 3> v;
+    for (long int index = 0; index < 100; index++)
+    {
+        long int time_stamp = 1000000000 + index * 5000000 + jitter(generator);
+        double t = static_cast<double>(time_stamp) * 1e-9;
+        v = fit.update(time_stamp, {1. + 2. * t + 3. * t * t, t, -t * t});
+        if (index >= 2)
+        {
+            ASSERT_NEAR(v[0], 2. + 6. * t, 1e-5);
+            ASSERT_NEAR(v[1], 1., 1e-5);
+            ASSERT_NEAR(v[2], -2. * t, 1e-5);
+            ASSERT_NEAR(fit.get_acceleration()[0], 6., 1e-3);
+        }
+    }
+
+    // trajectory of DummyServer (published at 100Hz) with a noise of 1mm
+    std::normal_distribution<double> noise(0., 0.001);
+    constexpr double frequency = 100.;
+    FiniteDifference finite_difference;
+    PolynomialFit polynomial(20, 2);
+    double fd_error = 0;
+    double polynomial_error = 0;
+    for (long int num = 0; num < 1000; num++)
+    {
+        long int time_stamp = num * static_cast<long int>(1e9 / frequency);
+        std::array<double, 3> position = DummyServer::trajectory(num);
+        for (double& p : position)
+        {
+            p += noise(generator);
+        }
+        // derivative of DummyServer::trajectory
+        double d = static_cast<double>(num + 1);
+        std::array<double, 3> velocity{-0.001 * frequency * sin(0.001 * d),
+                                       0.001 * frequency * cos(0.001 * d),
+                                       0.0005 * frequency * sin(-0.0005 * d)};
+        std::array<double, 3> fd_v =
+            finite_difference.update(time_stamp, position);
+        std::array<double, 3> polynomial_v =
+            polynomial.update(time_stamp, position);
+        if (num >= 20)
+        {
+            for (std::size_t dim = 0; dim < 3; dim++)
+            {
+                fd_error += std::abs(fd_v[dim] - velocity[dim]);
+                polynomial_error += std::abs(polynomial_v[dim] - velocity[dim]);
+            }
+        }
+    }
+    ASSERT_LT(polynomial_error, fd_error / 3.);
+
+    ASSERT_THROW(PolynomialFit(10, 3), std::invalid_argument);
+    ASSERT_THROW(PolynomialFit(2, 2), std::invalid_argument);
+    ASSERT_THROW(PolynomialFit(TENNICAM_CLIENT_POLYNOMIAL_MAX_WINDOW + 1, 1),
+                 std::invalid_argument);
+}
+
+TEST_F(TennicamClientTests, predictor)
+{
+    constexpr double g = 9.81;
+    std::array<double, 3> position{0.2, -1., 0.5};
+    std::array<double, 3> velocity{0.5, 4., 2.};
+    Ball ball(3, position, velocity, 1000000000);
+
+    // no drag: parabola
+    Predictor predictor(g, 0., 0.01, 50, 1, 0.);
+    Prediction prediction;
+    predictor.predict(ball, prediction);
+    ASSERT_EQ(prediction.ball_id, 3);
+    ASSERT_EQ(prediction.nb_steps, 50);
+    for (int step = 0; step < prediction.nb_steps; step++)
+    {
+        double t = 0.01 * (step + 1);
+        ASSERT_NEAR(prediction.positions[step][0], 0.2 + 0.5 * t, 1e-9);
+        ASSERT_NEAR(prediction.positions[step][1], -1. + 4. * t, 1e-9);
+        ASSERT_NEAR(prediction.positions[step][2],
+                    0.5 + 2. * t - 0.5 * g * t * t,
+                    1e-9);
+        ASSERT_NEAR(prediction.velocities[step][2], 2. - g * t, 1e-9);
+    }
+    ASSERT_TRUE(prediction.crosses_plane);
+    ASSERT_NEAR(prediction.plane_time, 0.25, 1e-6);
+    ASSERT_NEAR(prediction.plane_position[1], 0., 1e-9);
+    ASSERT_NEAR(prediction.plane_position[0], 0.2 + 0.5 * 0.25, 1e-6);
+
+    // drag slows the ball down
+    Predictor drag_predictor(g, 0.11, 0.01, 50, 1, 0.);
+    Prediction drag_prediction;
+    drag_predictor.predict(ball, drag_prediction);
+    ASSERT_TRUE(drag_prediction.crosses_plane);
+    ASSERT_GT(drag_prediction.plane_time, prediction.plane_time);
+
+    // plane out of reach
+    Predictor far_predictor(g, 0.11, 0.01, 50, 1, 10.);
+    far_predictor.predict(ball, prediction);
+    ASSERT_FALSE(prediction.crosses_plane);
+
+    ASSERT_THROW(Predictor(g, 0.11, 0.01, 0, 1, 0.), std::invalid_argument);
+    ASSERT_THROW(Predictor(g, 0.11, 0.01, 50, 3, 0.), std::invalid_argument);
+
+    // published via shared memory
+    const std::string segment_id = "tennicam_client_tests";
+    SharedRecord<internal::PredictionRecord> record(
+        prediction_segment_id(segment_id), SharedRecordMode::CREATE);
+    record.get().write(drag_prediction);
+    Prediction read = read_prediction(segment_id);
+    ASSERT_EQ(read.ball_id, 3);
+    ASSERT_DOUBLE_EQ(read.plane_time, drag_prediction.plane_time);
+    ASSERT_DOUBLE_EQ(read.positions[49][2], drag_prediction.positions[49][2]);
+    // reader opening the segment once
+    PredictionReader reader(segment_id);
+    ASSERT_EQ(reader.get().ball_id, 3);
+    record.get().write(prediction);
+    reader.read(read);
+    ASSERT_EQ(read.ball_id, prediction.ball_id);
+    ASSERT_DOUBLE_EQ(read.positions[49][2], prediction.positions[49][2]);
+    SharedRecord<internal::PredictionRecord>::clear(
+        prediction_segment_id(segment_id));
+}
+
+TEST_F(TennicamClientTests, trajectory_segmenter)
+{
+    // ball thrown toward the table (z=0), bouncing at t=0.2,
+    // then hit back (along y) at t=0.5, observed at 200Hz with noise
+    std::mt19937 generator(0);
+    std::normal_distribution<double> noise(0., 0.001);
+    TrajectorySegmenter segmenter(2., 1);
+    std::vector<long int> bounces;
+    std::vector<long int> hits;
+    for (long int index = 0; index < 140; index++)
+    {
+        double t = 0.005 * index;
+        std::array<double, 3> position;
+        if (t <= 0.2)
+        {
+            position = {0., 4. * t, 0.4 - 2. * t};
+        }
+        else if (t <= 0.5)
+        {
+            position = {0., 4. * t, 2. * (t - 0.2)};
+        }
+        else
+        {
+            position = {0., 2. - 5. * (t - 0.5), 0.6 + (t - 0.5)};
+        }
+        for (double& p : position)
+        {
+            p += noise(generator);
+        }
+        int events = segmenter.update(index * 5000000, position);
+        if (index == 0)
+        {
+            ASSERT_EQ(events, SEGMENT_START);
+        }
+        if (events & BOUNCE)
+        {
+            bounces.push_back(index);
+        }
+        if (events & HIT)
+        {
+            hits.push_back(index);
+        }
+    }
+    // reported one observation late
+    ASSERT_EQ(bounces, std::vector<long int>{41});
+    ASSERT_EQ(hits, std::vector<long int>{101});
+    ASSERT_EQ(segmenter.get_segment_id(), 2);
+
+    // ball lost: new segment
+    segmenter.reset();
+    ASSERT_EQ(segmenter.update(200 * 5000000, {0, 0, 0}), SEGMENT_START);
+    ASSERT_EQ(segmenter.get_segment_id(), 3);
+}
+
+TEST_F(TennicamClientTests, parse_json_frame)
+{
+    Frame frame;
+
+    std::string msg(
+        "{\"num\":12,\"obs\":[0.5,-1.25,3e-1],\"proc_time\":1,"
+        "\"time\":1654012345678901234}");
+    ASSERT_TRUE(parse_json_frame(msg.data(), msg.size(), frame));
+    ASSERT_EQ(frame.num, 12);
+    ASSERT_EQ(frame.time_stamp, 1654012345678901234);
+    ASSERT_DOUBLE_EQ(frame.proc_time, 1.);
+    ASSERT_TRUE(frame.detected);
+    ASSERT_DOUBLE_EQ(frame.position[0], 0.5);
+    ASSERT_DOUBLE_EQ(frame.position[1], -1.25);
+    ASSERT_DOUBLE_EQ(frame.position[2], 0.3);
+
+    msg = std::string(
+        " { \"num\" : 13 , \"time\" : 1000 , \"proc_time\" : 0.002 ,\n"
+        "   \"obs\" : null } ");
+    ASSERT_TRUE(parse_json_frame(msg.data(), msg.size(), frame));
+    ASSERT_EQ(frame.num, 13);
+    ASSERT_EQ(frame.time_stamp, 1000);
+    ASSERT_DOUBLE_EQ(frame.proc_time, 0.002);
+    ASSERT_FALSE(frame.detected);
+
+    // several balls detected
+    msg = std::string(
+        "{\"num\":14,\"time\":1001,"
+        "\"obs\":[[1,2,3], [4,5,6] ,[7,8,9]]}");
+    ASSERT_TRUE(parse_json_frame(msg.data(), msg.size(), frame));
+    ASSERT_TRUE(frame.detected);
+    ASSERT_EQ(frame.nb_detections, 3);
+    ASSERT_DOUBLE_EQ(frame.position[0], 1.);
+    ASSERT_DOUBLE_EQ(frame.detections[1][1], 5.);
+    ASSERT_DOUBLE_EQ(frame.detections[2][2], 9.);
+
+    // unexpected layouts: the generic json parser should be used
+    std::vector<std::string> unexpected{
+        "{\"num\":1,\"time\":2,\"obs\":[1,2]}",
+        "{\"num\":1,\"time\":2,\"obs\":[[1,2,3],[1,2]]}",
+        "{\"num\":1,\"time\":2,\"obs\":[1,2,3],\"other\":4}",
+        "{\"num\":1,\"obs\":[1,2,3]}",
+        "{\"num\":1,\"time\":2,\"obs\":[1,2,3]",
+        "{\"n\\u0075m\":1,\"time\":2,\"obs\":[1,2,3]}",
+        ""};
+    for (const std::string& u : unexpected)
+    {
+        ASSERT_FALSE(parse_json_frame(u.data(), u.size(), frame)) << u;
+    }
+}
+
+TEST_F(TennicamClientTests, binary_frame)
+{
+    Frame in;
+    in.num = 42;
+    in.time_stamp = 1654012345678901234;
+    in.proc_time = 0.003;
+    in.detected = true;
+    in.position = {0.1, -0.2, 0.3};
+
+    char buffer[binary_frame_size(1)];
+    std::size_t size = encode_binary_frame(in, buffer);
+    ASSERT_EQ(size, binary_frame_size(1));
+    ASSERT_TRUE(is_binary_frame(buffer, size));
+
+    Frame out;
+    ASSERT_TRUE(decode_binary_frame(buffer, size, out));
+    ASSERT_EQ(out.num, in.num);
+    ASSERT_EQ(out.time_stamp, in.time_stamp);
+    ASSERT_DOUBLE_EQ(out.proc_time, in.proc_time);
+    ASSERT_TRUE(out.detected);
+    for (std::size_t index = 0; index < 3; index++)
+    {
+        ASSERT_DOUBLE_EQ(out.position[index], in.position[index]);
+    }
+
+    // truncated
+    ASSERT_FALSE(decode_binary_frame(buffer, size - 1, out));
+
+    // several balls detected
+    in.nb_detections = 2;
+    in.detections[1] = {1., 2., 3.};
+    char buffer2[binary_frame_size(2)];
+    size = encode_binary_frame(in, buffer2);
+    ASSERT_EQ(size, binary_frame_size(2));
+    ASSERT_TRUE(decode_binary_frame(buffer2, size, out));
+    ASSERT_EQ(out.nb_detections, 2);
+    ASSERT_DOUBLE_EQ(out.position[1], in.position[1]);
+    ASSERT_DOUBLE_EQ(out.detections[1][2], 3.);
+
+    // no detection
+    in.detected = false;
+    size = encode_binary_frame(in, buffer);
+    ASSERT_EQ(size, binary_frame_size(0));
+    ASSERT_TRUE(decode_binary_frame(buffer, size, out));
+    ASSERT_FALSE(out.detected);
+
+    // json messages are not detected as binary frames
+    std::string json_msg("{\"num\":1,\"time\":2,\"obs\":null}");
+    ASSERT_FALSE(is_binary_frame(json_msg.data(), json_msg.size()));
+}
+
+TEST_F(TennicamClientTests, spsc_queue)
+{
+    SpscQueue<long int, 8> queue;
+    long int item;
+    ASSERT_FALSE(queue.pop(item));
+    for (long int i = 0; i < 8; i++)
+    {
+        ASSERT_TRUE(queue.push(i));
+    }
+    ASSERT_FALSE(queue.push(8));
+    ASSERT_EQ(queue.size(), 8);
+    for (long int i = 0; i < 8; i++)
+    {
+        ASSERT_TRUE(queue.pop(item));
+        ASSERT_EQ(item, i);
+    }
+    ASSERT_FALSE(queue.pop(item));
+
+    // one producer thread, one consumer thread
+    const long int nb_items = 100000;
+    std::thread producer(
+        [&queue]()
+        {
+            for (long int i = 0; i < nb_items; i++)
+            {
+                while (!queue.push(i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    long int expected = 0;
+    while (expected < nb_items)
+    {
+        if (queue.pop(item))
+        {
+            ASSERT_EQ(item, expected);
+            expected++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+
+TEST_F(TennicamClientTests, stall_timings)
+{
+    // no server: each frame waited for by the receive thread times out
+    DriverConfig config("localhost", 7671, {0., 0., 0.}, {0., 0., 0.});
+    config.receive_mode = ReceiveMode::POLL;
+    config.receive_timeout_ms = 5;
+    config.io_thread = true;
+    Driver driver(config);
+    driver.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    driver.stop();
+    // (all the items pushed by the receive thread)
+    driver.get();
+    const DriverTimings& timings = driver.get_timings();
+    ASSERT_GT(driver.get_nb_stalls(), 0);
+    ASSERT_EQ(timings.receive.count(), driver.get_nb_stalls());
+    // no frame decoded / processed
+    ASSERT_EQ(timings.decode.count(), 0);
+    ASSERT_EQ(timings.process.count(), 0);
+}
+
+TEST_F(TennicamClientTests, ingestion_all)
+{
+    DriverConfig config("localhost", 7672, {0., 0., 0.}, {0., 0., 0.});
+    config.receive_mode = ReceiveMode::POLL;
+    config.ingestion_policy = IngestionPolicy::ALL;
+    DummyServer server(config, WireFormat::BINARY, 1000.);
+    Driver driver(config);
+    driver.start();
+    server.start();
+    // waiting for the first ball
+    driver.get();
+    // several frames pending
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    Ball ball = driver.get();
+    server.stop();
+    driver.stop();
+
+    const std::vector<Ball>& batch = driver.get_batch();
+    ASSERT_GT(batch.size(), 5);
+    for (std::size_t index = 1; index < batch.size(); index++)
+    {
+        ASSERT_EQ(batch[index].get_ball_id(),
+                  batch[index - 1].get_ball_id() + 1);
+        ASSERT_GT(batch[index].get_time_stamp(),
+                  batch[index - 1].get_time_stamp());
+    }
+    ASSERT_EQ(batch.back().get_ball_id(), ball.get_ball_id());
+    ASSERT_EQ(batch.back().get_time_stamp(), ball.get_time_stamp());
+    ASSERT_EQ(batch.back().get_position(), ball.get_position());
+    // no frame skipped or lost
+    ASSERT_EQ(driver.get_frame_statistics().nb_lost_frames, 0);
+    ASSERT_EQ(driver.get_nb_skipped_frames(), 0);
+}
+
+TEST_F(TennicamClientTests, ingestion_latest)
+{
+    DriverConfig config("localhost", 7675, {0., 0., 0.}, {0., 0., 0.});
+    config.receive_mode = ReceiveMode::SPIN;
+    config.ingestion_policy = IngestionPolicy::LATEST;
+    DummyServer server(config, WireFormat::BINARY, 1000.);
+    Driver driver(config);
+    driver.start();
+    server.start();
+    // waiting for the first ball (all pending frames drained)
+    driver.get();
+    const long int first_num = driver.get_frame_statistics().last_num;
+    const long int nb_skipped = driver.get_nb_skipped_frames();
+    // several frames pending
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Ball ball = driver.get();
+    driver.stop();
+
+    // the newest frame is returned, all the others are skipped
+    const FrameStatistics fs = driver.get_frame_statistics();
+    const long int nb_drained = fs.last_num - first_num - 1;
+    ASSERT_GT(nb_drained, 5);
+    ASSERT_EQ(ball.get_position(), DummyServer::trajectory(fs.last_num));
+    ASSERT_EQ(ball.get_nb_skipped_frames(), nb_drained);
+    ASSERT_EQ(driver.get_nb_skipped_frames() - nb_skipped, nb_drained);
+    // skipped frames are not lost
+    ASSERT_EQ(fs.nb_lost_frames, 0);
+    ASSERT_EQ(fs.nb_frames, 2);
+
+    // no new frame: the same ball, nothing skipped
+    Ball again = driver.get();
+    ASSERT_EQ(again.get_ball_id(), ball.get_ball_id());
+    ASSERT_EQ(again.get_nb_skipped_frames(), 0);
+    ASSERT_EQ(driver.get_nb_skipped_frames() - nb_skipped, nb_drained);
+}
+
+TEST_F(TennicamClientTests, frame_statistics)
+{
+    const std::string segment_id = "tennicam_client_tests";
+    SharedRecord<internal::AtomicFrameStatistics> record(
+        frame_statistics_segment_id(segment_id), SharedRecordMode::CREATE);
+
+    SequenceTracker tracker;
+    long int nb_lost;
+    auto update = [&](long int num, long int nb_skipped)
+    {
+        SequenceTracker::Event event = tracker.update(num, nb_skipped, nb_lost);
+        record.get().add(event, num, nb_lost);
+        return event;
+    };
+
+    ASSERT_EQ(update(10, 0), SequenceTracker::FIRST);
+    ASSERT_EQ(update(11, 0), SequenceTracker::IN_ORDER);
+    ASSERT_EQ(update(14, 0), SequenceTracker::GAP);
+    ASSERT_EQ(nb_lost, 2);
+    ASSERT_EQ(update(14, 0), SequenceTracker::DUPLICATE);
+    ASSERT_EQ(update(13, 0), SequenceTracker::REORDERED);
+    ASSERT_EQ(update(15, 0), SequenceTracker::IN_ORDER);
+    // frames 16 and 17 skipped by the driver, i.e. not lost
+    ASSERT_EQ(update(18, 2), SequenceTracker::IN_ORDER);
+    ASSERT_EQ(update(21, 1), SequenceTracker::GAP);
+    ASSERT_EQ(nb_lost, 1);
+
+    FrameStatistics fs = read_frame_statistics(segment_id);
+    ASSERT_EQ(fs.nb_frames, 8);
+    ASSERT_EQ(fs.last_num, 21);
+    ASSERT_EQ(fs.nb_gaps, 2);
+    ASSERT_EQ(fs.nb_lost_frames, 3);
+    ASSERT_EQ(fs.nb_duplicates, 1);
+    ASSERT_EQ(fs.nb_reordered, 1);
+
+    // reader opening the segment once, seeing the later updates
+    FrameStatisticsReader reader(segment_id);
+    ASSERT_EQ(reader.get().nb_frames, 8);
+    update(22, 0);
+    fs = reader.get();
+    ASSERT_EQ(fs.nb_frames, 9);
+    ASSERT_EQ(fs.last_num, 22);
+
+    SharedRecord<internal::AtomicFrameStatistics>::clear(
+        frame_statistics_segment_id(segment_id));
+}
+
+TEST_F(TennicamClientTests, outlier_gate)
+{
+    // 100Hz, ball moving at 1m/s along x
+    const long int period = 10000000;
+    const std::array<double, 3> velocity{1., 0., 0.};
+    OutlierGate gate(30., 0.3, 2, 0.);
+    auto check = [&](int iteration, double x)
+    {
+        OutlierGate::Result result =
+            gate.check(iteration * period, {x, 0., 0.});
+        if (result != OutlierGate::OUTLIER)
+        {
+            gate.set_velocity(velocity);
+        }
+        return result;
+    };
+    ASSERT_EQ(check(0, 0.), OutlierGate::ACCEPTED);
+    ASSERT_EQ(check(1, 0.01), OutlierGate::ACCEPTED);
+    ASSERT_EQ(check(2, 0.02), OutlierGate::ACCEPTED);
+    // spurious detection (speed above 30m/s)
+    ASSERT_EQ(check(3, 2.), OutlierGate::OUTLIER);
+    // next observation consistent with the trajectory
+    ASSERT_EQ(check(4, 0.04), OutlierGate::ACCEPTED);
+    // below the max speed, but far from the predicted position
+    ASSERT_EQ(check(5, 0.25), OutlierGate::ACCEPTED);
+    ASSERT_EQ(check(6, 0.8), OutlierGate::OUTLIER);
+    ASSERT_EQ(check(7, 0.9), OutlierGate::OUTLIER);
+    // more than 2 consecutive outliers: tracking restarts
+    ASSERT_EQ(check(8, 1.), OutlierGate::RESTARTED);
+    ASSERT_EQ(check(9, 1.01), OutlierGate::ACCEPTED);
+    // after a reset, any observation is accepted
+    gate.reset();
+    ASSERT_EQ(check(10, 5.), OutlierGate::ACCEPTED);
+}
+
+TEST_F(TennicamClientTests, latency_compensation)
+{
+    DriverConfig config("localhost", 7660, {0., 0., 0.}, {0., 0., 0.});
+    config.latency_compensation = true;
+    config.latency_compensation_extra_ms = 2.;
+    config.latency_compensation_max_ms = 50.;
+    config.prediction_drag = 0.;
+    Driver driver(config);
+
+    const long int time_stamp = 1000000000;
+    Ball ball(0, {0., 0., 1.}, {1., 2., 0.}, time_stamp);
+    // observed 8ms ago, extrapolated to 10ms
+    driver.compensate_latency(ball, time_stamp + 8000000);
+    ASSERT_EQ(ball.get_time_stamp(), time_stamp);
+    ASSERT_EQ(ball.get_compensated_time_stamp(), time_stamp + 10000000);
+    ASSERT_NEAR(ball.get_position()[0], 0.01, 1e-9);
+    ASSERT_NEAR(ball.get_position()[1], 0.02, 1e-9);
+    ASSERT_NEAR(ball.get_position()[2], 1. - 0.5 * 9.81 * 1e-4, 1e-9);
+    ASSERT_NEAR(ball.get_velocity()[2], -9.81 * 0.01, 1e-9);
+
+    // too old: not extrapolated
+    Ball old(1, {0., 0., 1.}, {1., 2., 0.}, time_stamp);
+    driver.compensate_latency(old, time_stamp + 60000000);
+    ASSERT_EQ(old.get_compensated_time_stamp(), time_stamp);
+    ASSERT_EQ(old.get_position()[0], 0.);
+
+    // invalid ball: not extrapolated
+    Ball invalid;
+    driver.compensate_latency(invalid, time_stamp);
+    ASSERT_EQ(invalid.get_compensated_time_stamp(), -1);
+}
+
+TEST_F(TennicamClientTests, multi_ball_latency_compensation)
+{
+    // the tracks are compensated at each call to get, including the
+    // calls returning the same observations again
+    DriverConfig config("localhost", 7673, {0., 0., 0.}, {0., 0., 0.});
+    config.receive_mode = ReceiveMode::POLL;
+    config.io_thread = true;
+    config.multi_ball = true;
+    config.latency_compensation = true;
+    config.prediction_drag = 0.;
+    DummyServer server(config, WireFormat::BINARY, 50.);
+    Driver driver(config);
+    driver.start();
+    server.start();
+    long int ball_id = -1;
+    // vertical velocity of the observed ball (i.e. before compensation)
+    double velocity = 0;
+    int nb_repeated = 0;
+    for (int iteration = 0; iteration < 200; iteration++)
+    {
+        driver.get();
+        const Ball& ball = driver.get_balls()[0];
+        const long int horizon =
+            ball.get_compensated_time_stamp() - ball.get_time_stamp();
+        if (ball.get_ball_id() >= 0 && horizon > 0)
+        {
+            // (no drag: only gravity changes the velocity)
+            const double observed =
+                ball.get_velocity()[2] +
+                config.gravity * static_cast<double>(horizon) * 1e-9;
+            if (ball.get_ball_id() == ball_id)
+            {
+                ASSERT_NEAR(observed, velocity, 1e-9);
+                nb_repeated++;
+            }
+            ball_id = ball.get_ball_id();
+            velocity = observed;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    server.stop();
+    driver.stop();
+    ASSERT_GT(nb_repeated, 50);
+}
+
+TEST_F(TennicamClientTests, multi_ball_tracker)
+{
+    DriverConfig config;
+    config.gravity = 0.;
+    config.multi_ball_max_distance = 0.3;
+    config.multi_ball_max_missed = 1;
+    MultiBallTracker tracker(config);
+
+    // two balls crossing each other (along x, 10m/s), 100Hz
+    const long int period = 10000000;
+    auto positions = [](int iteration)
+    {
+        double x = -0.5 + 0.1 * iteration;
+        return std::array<std::array<double, 3>, 2>{
+            {{x, 0., 1.}, {-x, 0.05, 1.}}};
+    };
+    for (int iteration = 0; iteration < 10; iteration++)
+    {
+        std::array<std::array<double, 3>, 2> p = positions(iteration);
+        // detections in an arbitrary order
+        if (iteration % 2)
+        {
+            std::swap(p[0], p[1]);
+        }
+        tracker.update(iteration * period, p.data(), 2);
+    }
+    ASSERT_EQ(tracker.get_nb_tracks(), 2);
+    const Balls& balls = tracker.get_balls();
+    // the tracks kept their ball through the crossing
+    ASSERT_NEAR(balls[0].get_position()[0], 0.4, 1e-9);
+    ASSERT_NEAR(balls[0].get_velocity()[0], 10., 1e-6);
+    ASSERT_NEAR(balls[1].get_position()[0], -0.4, 1e-9);
+    ASSERT_NEAR(balls[1].get_velocity()[0], -10., 1e-6);
+    ASSERT_EQ(balls[0].get_ball_id(), 9);
+    ASSERT_EQ(balls[0].get_segment_id(), 0);
+    ASSERT_EQ(balls[1].get_segment_id(), 1);
+    ASSERT_FALSE(balls[2].get_ball_id() >= 0);
+
+    // a third ball appears far from the others
+    std::array<std::array<double, 3>, 3> p3{
+        {{0.5, 0., 1.}, {-0.5, 0.05, 1.}, {0., 3., 1.}}};
+    tracker.update(10 * period, p3.data(), 3);
+    ASSERT_EQ(tracker.get_nb_tracks(), 3);
+    ASSERT_EQ(tracker.get_balls()[2].get_segment_id(), 2);
+    ASSERT_TRUE(tracker.get_balls()[2].get_events() & SEGMENT_START);
+
+    // tracks closed after more than max_missed frames without detection
+    tracker.miss();
+    ASSERT_EQ(tracker.get_nb_tracks(), 3);
+    tracker.miss();
+    ASSERT_EQ(tracker.get_nb_tracks(), 0);
+    ASSERT_EQ(tracker.get_balls()[0].get_ball_id(), -1);
+}
+
+TEST_F(TennicamClientTests, assignment)
+{
+    // random square cost matrices, compared with brute force
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> distribution(0., 1.);
+    for (std::size_t n = 1; n <= 6; n++)
+    {
+        internal::CostMatrix cost;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            for (std::size_t j = 0; j < n; j++)
+            {
+                cost[i][j] = distribution(generator);
+            }
+        }
+        std::array<std::size_t, internal::MAX_ASSOCIATION> assignment;
+        internal::assign(cost, n, assignment);
+        double total = 0;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            total += cost[i][assignment[i]];
+        }
+        std::vector<std::size_t> permutation(n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            permutation[i] = i;
+        }
+        double best = std::numeric_limits<double>::infinity();
+        do
+        {
+            double t = 0;
+            for (std::size_t i = 0; i < n; i++)
+            {
+                t += cost[i][permutation[i]];
+            }
+            best = std::min(best, t);
+        } while (std::next_permutation(permutation.begin(), permutation.end()));
+        ASSERT_NEAR(total, best, 1e-12);
+    }
+}
+
+// o80 like history (see query_state)
+class TestHistory
+{
+public:
+    Ball read(long int index)
+    {
+        nb_reads++;
+        return balls[index];
+    }
+    // invalid ball, as written by Driver::get after a valid ball
+    // observed at time_stamp
+    static Ball lost(long int time_stamp)
+    {
+        Ball ball;
+        ball.set_time_stamp(time_stamp);
+        return ball;
+    }
+    std::vector<Ball> balls;
+    long int nb_reads = 0;
+};
+
+TEST_F(TennicamClientTests, query_state)
+{
+    // ballistic flight (gravity only, exactly represented by cubic
+    // Hermite interpolation), observed at 180Hz
+    const double g = 9.81;
+    const long int period = 5555556;
+    const long int t_start = 1000000000;
+    auto position = [&](long int t)
+    {
+        double s = static_cast<double>(t - t_start) * 1e-9;
+        return std::array<double, 3>{
+            s, 2. - 3. * s, 1. + 4. * s - 0.5 * g * s * s};
+    };
+    auto velocity = [&](long int t)
+    {
+        double s = static_cast<double>(t - t_start) * 1e-9;
+        return std::array<double, 3>{1., -3., 4. - g * s};
+    };
+    TestHistory history;
+    history.balls.push_back(Ball());
+    // each ball is written several times, extrapolated to the time it
+    // is written (see DriverConfig::latency_compensation), or not (too
+    // old): the compensated time stamps are not ordered
+    const std::array<long int, 3> compensations{2000000, 0, 5000000};
+    for (long int id = 0; id < 20; id++)
+    {
+        long int t = t_start + id * period;
+        for (long int compensation : compensations)
+        {
+            long int tc = t + compensation;
+            Ball ball(id, position(tc), velocity(tc), t);
+            ball.set_compensated_time_stamp(tc);
+            history.balls.push_back(ball);
+        }
+        // ball lost for a few iterations
+        if (id == 10)
+        {
+            history.balls.insert(history.balls.end(), 5, TestHistory::lost(t));
+        }
+    }
+    const long int newest = history.balls.size() - 1;
+
+    auto check = [&](long int t, bool extrapolated, long int ball_id)
+    {
+        BallState state;
+        ASSERT_TRUE(query_state(history, 0, newest, t, g, state));
+        ASSERT_EQ(state.extrapolated, extrapolated);
+        ASSERT_EQ(state.ball_id, ball_id);
+        ASSERT_EQ(state.time_stamp, t);
+        for (std::size_t dim = 0; dim < 3; dim++)
+        {
+            ASSERT_NEAR(state.position[dim], position(t)[dim], 1e-9);
+            ASSERT_NEAR(state.velocity[dim], velocity(t)[dim], 1e-9);
+        }
+    };
+    // 1kHz control loop
+    for (long int t = t_start; t < t_start + 10 * period; t += 1000000)
+    {
+        check(t, false, (t - t_start) / period);
+    }
+    // exactly on an observation
+    check(t_start + 5 * period, false, 5);
+    // ball lost after ball 10
+    check(t_start + 10 * period + 1000000, true, 10);
+    // after the latest ball
+    check(t_start + 25 * period, true, 19);
+    // before the first ball
+    BallState state;
+    ASSERT_FALSE(query_state(history, 0, newest, t_start - 1, g, state));
+}
+
+TEST_F(TennicamClientTests, query_state_invalid_runs)
+{
+    // a few balls, the ball being lost for long periods in between
+    // (e.g. o80 history of the standalone running at 1kHz)
+    const long int period = 1000000000;
+    const long int t_start = 1000000000;
+    const long int run = 100000;
+    const double g = 9.81;
+    TestHistory history;
+    history.balls.insert(history.balls.end(), run, Ball());
+    for (long int id = 0; id < 5; id++)
+    {
+        long int t = t_start + id * period;
+        history.balls.push_back(Ball(id, {0., 0., 1.}, {0., 0., 0.}, t));
+        history.balls.insert(history.balls.end(), run, TestHistory::lost(t));
+    }
+    const long int newest = history.balls.size() - 1;
+    // two binary searches at most
+    const long int max_reads =
+        2 * static_cast<long int>(std::ceil(std::log2(newest + 1))) + 4;
+
+    auto check = [&](long int oldest, long int t, long int ball_id)
+    {
+        BallState state;
+        history.nb_reads = 0;
+        bool found = query_state(history, oldest, newest, t, g, state);
+        ASSERT_LE(history.nb_reads, max_reads);
+        ASSERT_EQ(found, ball_id >= 0);
+        if (found)
+        {
+            ASSERT_EQ(state.ball_id, ball_id);
+            ASSERT_TRUE(state.extrapolated);
+            double s = static_cast<double>(t - t_start - ball_id * period) *
+                       1e-9;
+            ASSERT_NEAR(state.position[2], 1. - 0.5 * g * s * s, 1e-9);
+        }
+    };
+    // before the first ball
+    check(0, t_start - 1, -1);
+    // on each ball, and while each ball is lost
+    for (long int id = 0; id < 5; id++)
+    {
+        long int t = t_start + id * period;
+        check(0, t, id);
+        check(0, t + period / 2, id);
+    }
+    // after the latest ball
+    check(0, t_start + 10 * period, 4);
+    // ball 1 overwritten (older than the available history)
+    check(2 * run + 2, t_start + period + 1, -1);
+    check(2 * run + 2, t_start + 2 * period + 1, 2);
+}
+
+TEST_F(TennicamClientTests, clock_sync)
+{
+    // local clock 3s ahead of the remote clock, with a drift
+    // of 20 ppm, and a latency of at least 1ms
+    const long int offset = 3000000000;
+    const double drift = 20.;
+    const long int min_latency = 1000000;
+    std::mt19937 generator(0);
+    std::exponential_distribution<double> latency(1. / 2e6);
+    ClockSync clock_sync(1000000000, 30, 0, 20000000);
+    ASSERT_FALSE(clock_sync.get().synchronized);
+
+    const long int period = 5555556;
+    const long int start = 1000000000000;
+    auto local = [&](long int remote)
+    {
+        return remote + offset +
+               static_cast<long int>(drift * 1e-6 * (remote - start));
+    };
+    long int remote = start;
+    for (int frame = 0; frame < 60 * 180; frame++)
+    {
+        remote += period;
+        clock_sync.add(
+            remote,
+            local(remote) + min_latency +
+                static_cast<long int>(latency(generator)));
+    }
+    ClockOffset co = clock_sync.get();
+    ASSERT_TRUE(co.synchronized);
+    ASSERT_EQ(co.nb_windows, 30);
+    ASSERT_NEAR(co.drift, drift, 2.);
+    // the offset includes the minimal latency
+    ASSERT_NEAR(static_cast<double>(co.to_local(remote)),
+                static_cast<double>(local(remote) + min_latency),
+                100000.);
+
+    // remote clock set 1s backward: the estimation restarts
+    for (int frame = 0; frame < 5 * 180; frame++)
+    {
+        remote += period;
+        clock_sync.add(remote - 1000000000,
+                       local(remote) + min_latency +
+                           static_cast<long int>(latency(generator)));
+    }
+    co = clock_sync.get();
+    ASSERT_EQ(co.nb_resets, 1);
+    ASSERT_NEAR(static_cast<double>(co.to_local(remote - 1000000000)),
+                static_cast<double>(local(remote) + min_latency),
+                100000.);
+
+    // published via shared memory
+    const std::string segment_id = "tennicam_client_tests";
+    SharedRecord<internal::ClockOffsetRecord> record(
+        clock_offset_segment_id(segment_id), SharedRecordMode::CREATE);
+    ClockOffsetReader reader(segment_id);
+    ASSERT_FALSE(reader.get().synchronized);
+    record.get().write(co);
+    ASSERT_EQ(reader.get().offset_ns, co.offset_ns);
+    ASSERT_EQ(read_clock_offset(segment_id).nb_resets, 1);
+    SharedRecord<internal::ClockOffsetRecord>::clear(
+        clock_offset_segment_id(segment_id));
+}
+
+TEST_F(TennicamClientTests, resampling)
+{
+    // ballistic ball observed at 180Hz, resampled at 1kHz
+    // (10ms behind the latest observation)
+    const double gravity = 9.81;
+    const long int period = 5555556;
+    const long int start = 1000000000000;
+    auto ball_at = [&](long int ball_id, long int time_stamp)
+    {
+        const double t = static_cast<double>(time_stamp - start) * 1e-9;
+        std::array<double, 3> position{
+            0.5 + 4. * t, -1. * t, 1. + 2. * t - 0.5 * gravity * t * t};
+        std::array<double, 3> velocity{4., -1., 2. - gravity * t};
+        return Ball(ball_id, position, velocity, time_stamp);
+    };
+    Resampler resampler(1000., 0.01, 0.05, 0.02, gravity);
+    ASSERT_LT(resampler.sample().get_ball_id(), 0);
+
+    long int ball_id = 0;
+    long int previous_ball_id = -1;
+    long int previous_time_stamp = -1;
+    for (long int tick = 0; tick < 300; tick++)
+    {
+        const long int now = start + tick * 1000000;
+        while (start + ball_id * period <= now)
+        {
+            resampler.add(ball_at(ball_id, start + ball_id * period));
+            ball_id++;
+        }
+        Ball ball = resampler.sample();
+        ASSERT_GE(ball.get_ball_id(), 0);
+        if (previous_ball_id >= 0)
+        {
+            ASSERT_EQ(ball.get_ball_id(), previous_ball_id + 1);
+            ASSERT_EQ(ball.get_time_stamp(), previous_time_stamp + 1000000);
+        }
+        previous_ball_id = ball.get_ball_id();
+        previous_time_stamp = ball.get_time_stamp();
+        Ball expected = ball_at(0, std::max(start, ball.get_time_stamp()));
+        if (ball.get_time_stamp() >= start)
+        {
+            for (std::size_t dim = 0; dim < 3; dim++)
+            {
+                ASSERT_NEAR(ball.get_position()[dim],
+                            expected.get_position()[dim],
+                            1e-6);
+                ASSERT_NEAR(ball.get_velocity()[dim],
+                            expected.get_velocity()[dim],
+                            1e-6);
+            }
+        }
+    }
+
+    // no new observation: predicted for 50ms, then invalid
+    long int nb_valid = 0;
+    for (int tick = 0; tick < 100; tick++)
+    {
+        if (resampler.sample().get_ball_id() >= 0)
+        {
+            nb_valid++;
+        }
+    }
+    ASSERT_GT(nb_valid, 50);
+    ASSERT_LT(nb_valid, 70);
+
+    // ball lost
+    resampler.add(ball_at(ball_id, start + ball_id * period));
+    ASSERT_GE(resampler.sample().get_ball_id(), 0);
+    resampler.add(Ball());
+    ASSERT_LT(resampler.sample().get_ball_id(), 0);
+
+    // events and skipped frames of the observations reported by the
+    // next sample (once)
+    Ball first = ball_at(ball_id, start + ball_id * period);
+    first.set_segment(4, SEGMENT_START);
+    resampler.add(first);
+    ball_id++;
+    ASSERT_EQ(resampler.sample().get_events(), SEGMENT_START);
+    Ball bounce = ball_at(ball_id, start + ball_id * period);
+    bounce.set_segment(4, BOUNCE);
+    bounce.set_nb_skipped_frames(2);
+    resampler.add(bounce);
+    ball_id++;
+    Ball outlier = ball_at(ball_id, start + ball_id * period);
+    outlier.set_segment(4, OUTLIER);
+    outlier.set_nb_skipped_frames(1);
+    resampler.add(outlier);
+    // (already added)
+    resampler.add(outlier);
+    Ball ball = resampler.sample();
+    ASSERT_GE(ball.get_ball_id(), 0);
+    ASSERT_EQ(ball.get_segment_id(), 4);
+    ASSERT_EQ(ball.get_events(), BOUNCE | OUTLIER);
+    ASSERT_EQ(ball.get_nb_skipped_frames(), 3);
+    ball = resampler.sample();
+    ASSERT_EQ(ball.get_events(), 0);
+    ASSERT_EQ(ball.get_nb_skipped_frames(), 0);
+}
+
+TEST_F(TennicamClientTests, ball_waiter)
+{
+    const std::string segment_id = "tennicam_client_tests";
+    SharedRecord<internal::NewBallRecord> record(
+        new_ball_segment_id(segment_id), SharedRecordMode::CREATE);
+    BallWaiter waiter(segment_id);
+    ASSERT_LT(waiter.latest().get_ball_id(), 0);
+
+    // no new ball: timeout
+    Ball ball;
+    ASSERT_FALSE(waiter.wait(1000, ball));
+
+    // woken up by a new ball
+    std::thread notifier(
+        [&record]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            internal::notify_new_ball(
+                record.get(), Ball(3, {1., 2., 3.}, {0., 0., 0.}, 100));
+        });
+    ASSERT_TRUE(waiter.wait(5000000, ball));
+    notifier.join();
+    ASSERT_EQ(ball.get_ball_id(), 3);
+    ASSERT_EQ(ball.get_time_stamp(), 100);
+    ASSERT_EQ(ball.get_position()[1], 2.);
+
+    // same ball again: timeout
+    internal::notify_new_ball(
+        record.get(), Ball(3, {1., 2., 3.}, {0., 0., 0.}, 100));
+    ASSERT_FALSE(waiter.wait(1000, ball));
+    // already produced new ball: returned without waiting
+    internal::notify_new_ball(
+        record.get(), Ball(4, {1., 2., 3.}, {0., 0., 0.}, 200));
+    ASSERT_TRUE(waiter.wait(0, ball));
+    ASSERT_EQ(ball.get_ball_id(), 4);
+
+    SharedRecord<internal::NewBallRecord>::clear(
+        new_ball_segment_id(segment_id));
+}
+
+TEST_F(TennicamClientTests, publish_on_change_config)
+{
+    // the driver should block until a frame arrives
+    DriverConfig config;
+    config.receive_mode = ReceiveMode::SPIN;
+    ASSERT_THROW(
+        PublishOnChangeStandalone(
+            std::make_shared<Driver>(config), "tennicam_client_tests", 50000),
+        std::invalid_argument);
+    config.receive_mode = ReceiveMode::POLL;
+    config.io_thread = true;
+    ASSERT_THROW(
+        PublishOnChangeStandalone(
+            std::make_shared<Driver>(config), "tennicam_client_tests", 50000),
+        std::invalid_argument);
+    config.io_thread = false;
+    // stop would block until a frame arrives
+    config.receive_timeout_ms = -1;
+    ASSERT_THROW(
+        PublishOnChangeStandalone(
+            std::make_shared<Driver>(config), "tennicam_client_tests", 50000),
+        std::invalid_argument);
+    config.receive_timeout_ms = 100;
+    // a resampled ball at each call, not at each frame
+    config.resampling = true;
+    ASSERT_THROW(
+        PublishOnChangeStandalone(
+            std::make_shared<Driver>(config), "tennicam_client_tests", 50000),
+        std::invalid_argument);
+    config.resampling = false;
+    ASSERT_THROW(
+        PublishOnChangeStandalone(
+            std::make_shared<Driver>(config), "tennicam_client_tests", 1234),
+        std::invalid_argument);
+}
+
+TEST_F(TennicamClientTests, publish_on_change)
+{
+    const std::string segment_id = "tennicam_client_tests";
+    o80::clear_shared_memory(segment_id);
+    DriverConfig config("localhost", 7674, {0., 0., 0.}, {0., 0., 0.});
+    config.receive_mode = ReceiveMode::POLL;
+    config.receive_timeout_ms = 20;
+    config.ingestion_policy = IngestionPolicy::ALL;
+    DummyServer server(config, WireFormat::BINARY, 500.);
+    std::shared_ptr<Driver> driver = std::make_shared<Driver>(config);
+    PublishOnChangeStandalone standalone(driver, segment_id, 1000);
+    standalone.start();
+    server.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // ball lost: the driver times out several times
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    standalone.stop();
+
+    o80::FrontEnd<1000, 1, Ball, o80::VoidExtendedState> frontend(segment_id);
+    const long int newest = frontend.latest().get_iteration();
+    ASSERT_EQ(newest + 1, standalone.get_nb_published());
+    ASSERT_GT(newest, 10);
+    long int ball_id = -1;
+    for (long int iteration = 0; iteration < newest; iteration++)
+    {
+        // each new ball written once (batches of balls included)
+        Ball ball = frontend.read(iteration).get_observed_states().get(0);
+        ASSERT_EQ(ball.get_ball_id(), ball_id + 1);
+        ball_id = ball.get_ball_id();
+    }
+    // a single invalid ball when the ball is lost, carrying the
+    // time stamp of the latest ball (see query_state)
+    Ball lost = frontend.read(newest).get_observed_states().get(0);
+    ASSERT_LT(lost.get_ball_id(), 0);
+    ASSERT_EQ(lost.get_time_stamp(),
+              frontend.read(newest - 1)
+                  .get_observed_states()
+                  .get(0)
+                  .get_time_stamp());
+
+    o80::clear_shared_memory(segment_id);
+    SharedRecord<int>::clear(history_size_segment_id(segment_id));
+    SharedRecord<int>::clear(frame_statistics_segment_id(segment_id));
+    SharedRecord<int>::clear(new_ball_segment_id(segment_id));
+}